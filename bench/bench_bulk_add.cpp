@@ -0,0 +1,62 @@
+// Benchmark: bulk addRecord throughput.
+//
+// Usage: bench_bulk_add [records]   (default 1000000)
+//
+// Adds records with valid, unique ISBN-13s into an empty catalog and reports
+// adds/sec at every power-of-ten checkpoint. With indexed duplicate checks
+// and a regex-free validator the rate should stay flat as the catalog grows.
+
+#include "LibraryManager.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+namespace {
+
+const char* BENCH_FILE = "bench_bulk_add.bin";
+
+// Build a valid ISBN-13 from a sequence number
+std::string makeIsbn13(long sequence) {
+    std::string digits = "978" + std::to_string(1000000000L + sequence).substr(1);
+    int sum = 0;
+    for (int i = 0; i < 12; ++i) {
+        sum += (digits[i] - '0') * (i % 2 == 0 ? 1 : 3);
+    }
+    digits += static_cast<char>('0' + (10 - sum % 10) % 10);
+    return digits;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    long records = argc > 1 ? std::stol(argv[1]) : 1000000;
+    std::remove(BENCH_FILE);
+
+    std::streambuf* savedOut = std::cout.rdbuf(nullptr);
+    std::streambuf* savedErr = std::cerr.rdbuf(nullptr);
+    {
+        LibraryManager manager(BENCH_FILE);
+        std::ostream report(savedOut);
+        report << std::left << std::setw(12) << "records" << "adds/sec" << std::endl;
+
+        auto start = std::chrono::steady_clock::now();
+        long checkpoint = 1000;
+        for (long i = 1; i <= records; ++i) {
+            manager.addRecord("Title " + std::to_string(i), "Author " + std::to_string(i % 5000),
+                              1900 + i % 120, makeIsbn13(i), "Fiction");
+            if (i == checkpoint || i == records) {
+                auto elapsed = std::chrono::steady_clock::now() - start;
+                double seconds = std::chrono::duration<double>(elapsed).count();
+                report << std::setw(12) << i << std::fixed << std::setprecision(0)
+                       << (i / seconds) << std::endl;
+                checkpoint *= 10;
+            }
+        }
+    }
+    std::cout.rdbuf(savedOut);
+    std::cerr.rdbuf(savedErr);
+    std::remove(BENCH_FILE);
+    return 0;
+}
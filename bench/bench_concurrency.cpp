@@ -0,0 +1,199 @@
+// Benchmark and stress run: many threads reading and writing one catalog.
+//
+// Usage: bench_concurrency [records] [seconds] [maxThreads]
+//        (defaults 200000, 1 and std::thread::hardware_concurrency())
+//
+// For each read/write mix, 1, 2, 4, ... maxThreads threads share one
+// LibraryManager for the given time. Reads are ID and ISBN lookups, title
+// searches and availability counts, made inside a Snapshot and checked
+// against each other; writes are borrows, returns, year updates and
+// add/delete pairs. Reports reads and writes per second, and exits with
+// status 1 if any read saw an inconsistent catalog.
+
+#include "LibraryManager.h"
+#include "CatalogFile.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* BENCH_FILE = "bench_concurrency.bin";
+
+uint32_t scramble(uint32_t value) {
+    value ^= value >> 16;
+    value *= 0x45d9f3bu;
+    value ^= value >> 16;
+    return value;
+}
+
+// A valid ISBN-13 for number
+std::string isbnFor(long number) {
+    std::string digits = "978" + std::to_string(1000000000L + number % 1000000000L).substr(1);
+    int sum = 0;
+    for (size_t i = 0; i < 12; ++i) {
+        sum += (digits[i] - '0') * (i % 2 ? 3 : 1);
+    }
+    return digits + static_cast<char>('0' + (10 - sum % 10) % 10);
+}
+
+void writeCatalog(long records) {
+    std::vector<Book> books;
+    books.reserve(records);
+    for (int id = 1; id <= records; ++id) {
+        uint32_t r = scramble(id);
+        books.emplace_back(id, "Title " + std::to_string(r % 100000) + " of the series",
+                           "Author " + std::to_string(r % 20000), 1500 + (r >> 12) % 525, isbnFor(id),
+                           "Fiction", (r >> 20) % 4 != 0);
+    }
+    CatalogFile::write(BENCH_FILE, books, static_cast<int>(records) + 1);
+}
+
+struct Counters {
+    std::atomic<long> reads{0};
+    std::atomic<long> writes{0};
+    std::atomic<long> violations{0};
+};
+
+// One consistent group of reads; false if the catalog contradicted itself
+bool readOnce(LibraryManager& manager, std::mt19937& random, long records) {
+    LibraryManager::Snapshot snapshot = manager.snapshot();
+    int id = 1 + static_cast<int>(random() % records);
+    Book* book = manager.searchRecordByID(id);
+    if (!book || book->getId() != id) {
+        return false;
+    }
+    if (manager.searchRecordByISBN(std::string(book->getIsbn())) != book) {
+        return false;
+    }
+    if (random() % 256 == 0) {
+        std::vector<Book*> matches = manager.searchRecordsByTitle(std::string(book->getTitle()));
+        if (std::find(matches.begin(), matches.end(), book) == matches.end()) {
+            return false;
+        }
+    }
+    if (random() % 256 == 0) {
+        // Borrows and returns go on during a snapshot, so the two counts
+        // need not add up; each must still be within the total
+        long total = manager.getTotalBooks();
+        if (manager.getAvailableBooks() > total || manager.getBorrowedBooks() > total || total < records) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// One write, chosen at random
+void writeOnce(LibraryManager& manager, std::mt19937& random, long records, std::vector<int>& added,
+               long& nextIsbn) {
+    int id = 1 + static_cast<int>(random() % records);
+    switch (random() % 8) {
+        case 0: {
+            LibraryManager::BookUpdate update;
+            update.year = 1900 + static_cast<int>(random() % 100);
+            manager.updateRecord(id, update);
+            break;
+        }
+        case 1:
+            if (added.size() < 8) {
+                int newId = 0;
+                if (manager.addRecord("Added title", "Added author", 2000, isbnFor(nextIsbn++), "New",
+                                      &newId) == Status::Ok) {
+                    added.push_back(newId);
+                }
+            } else {
+                manager.deleteRecord(added.back());
+                added.pop_back();
+            }
+            break;
+        default:
+            if (manager.borrowBook(id) == Status::AlreadyBorrowed) {
+                manager.returnBook(id);
+            }
+    }
+}
+
+// Run threads threads for the given time with writePercent percent writes
+void runMix(LibraryManager& manager, long records, unsigned threads, unsigned writePercent, double seconds,
+            Counters& counters) {
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937 random(t * 7919 + writePercent);
+            std::vector<int> added;
+            long nextIsbn = records + 1 + static_cast<long>(t) * 100000000L / threads;
+            long reads = 0;
+            long writes = 0;
+            long violations = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (random() % 100 < writePercent) {
+                    writeOnce(manager, random, records, added, nextIsbn);
+                    ++writes;
+                } else {
+                    violations += readOnce(manager, random, records) ? 0 : 1;
+                    ++reads;
+                }
+            }
+            for (int id : added) {
+                manager.deleteRecord(id);
+            }
+            counters.reads += reads;
+            counters.writes += writes;
+            counters.violations += violations;
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    long records = argc > 1 ? std::stol(argv[1]) : 200000;
+    double seconds = argc > 2 ? std::stod(argv[2]) : 1.0;
+    unsigned maxThreads = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3]))
+                                   : std::max(1u, std::thread::hardware_concurrency());
+    std::remove(BENCH_FILE);
+    std::remove((std::string(BENCH_FILE) + ".journal").c_str());
+    writeCatalog(records);
+
+    long violations = 0;
+    {
+        LibraryManager manager(BENCH_FILE);
+        manager.setDurability(Journal::Durability::None);
+        manager.setCheckpointThreshold(UINT64_MAX);
+        manager.searchRecordByISBN(isbnFor(1));  // build the indexes before timing
+
+        std::cout << records << " records, " << std::thread::hardware_concurrency() << " hardware threads, "
+                  << seconds << " s per run" << std::endl;
+        std::cout << std::left << std::setw(10) << "writes" << std::setw(10) << "threads" << std::setw(14)
+                  << "reads/sec" << "writes/sec" << std::endl;
+        for (unsigned writePercent : {1u, 10u, 50u}) {
+            for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+                Counters counters;
+                runMix(manager, records, threads, writePercent, seconds, counters);
+                violations += counters.violations;
+                std::cout << std::setw(10) << (std::to_string(writePercent) + "%") << std::setw(10) << threads
+                          << std::setw(14) << static_cast<long>(counters.reads / seconds)
+                          << static_cast<long>(counters.writes / seconds) << std::endl;
+            }
+        }
+        std::cout << violations << " inconsistent reads" << std::endl;
+    }
+
+    std::remove(BENCH_FILE);
+    std::remove((std::string(BENCH_FILE) + ".journal").c_str());
+    return violations == 0 ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+// Benchmark: CSV export throughput.
+//
+// Usage: bench_csv_export [records] [maxThreads]
+//        (defaults 2000000 and std::thread::hardware_concurrency())
+//
+// Compares the former per-row path (an ostringstream and a temporary string
+// per book, written through the stream) with exportToCSV at 1, 2, 4, ...
+// maxThreads threads, and reports MB/s of CSV written.
+
+#include "LibraryManager.h"
+#include "CatalogFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* BENCH_FILE = "bench_csv_export.bin";
+const char* CSV_FILE = "bench_csv_export.csv";
+
+uint32_t scramble(uint32_t value) {
+    value ^= value >> 16;
+    value *= 0x45d9f3bu;
+    value ^= value >> 16;
+    return value;
+}
+
+void writeCatalog(long records) {
+    std::vector<Book> books;
+    books.reserve(records);
+    for (int id = 1; id <= records; ++id) {
+        uint32_t r = scramble(id);
+        std::string title = "Title " + std::to_string(r % 100000) + (r % 8 == 0 ? ", Volume 2" : " of the series");
+        books.emplace_back(id, title, "Author " + std::to_string(r % 20000), 1500 + (r >> 12) % 525,
+                           std::to_string(9780000000000LL + id), "Fiction", (r >> 20) % 4 != 0);
+    }
+    CatalogFile::write(BENCH_FILE, books, static_cast<int>(records) + 1);
+}
+
+// The export loop as it was: one ostringstream per row
+void exportPerRow(LibraryManager& manager, long records) {
+    std::ofstream file(CSV_FILE);
+    file << "ID,Title,Author,Year,ISBN,Category,Status\n";
+    for (int id = 1; id <= records; ++id) {
+        const Book* book = manager.searchRecordByID(id);
+        std::ostringstream oss;
+        oss << book->getId() << "," << book->getTitle() << "," << book->getAuthor() << "," << book->getYear()
+            << "," << book->getIsbn() << "," << book->getCategory() << ","
+            << (book->getAvailability() ? "Available" : "Borrowed");
+        file << oss.str() << "\n";
+    }
+}
+
+// Seconds taken by operation
+double seconds(const std::function<void()>& operation) {
+    auto start = std::chrono::steady_clock::now();
+    operation();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double megabytes(const char* filename) {
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    return static_cast<double>(file.tellg()) / (1 << 20);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    long records = argc > 1 ? std::stol(argv[1]) : 2000000;
+    unsigned maxThreads = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2]))
+                                   : std::max(1u, std::thread::hardware_concurrency());
+    std::remove(BENCH_FILE);
+    writeCatalog(records);
+
+    std::streambuf* saved = std::cout.rdbuf(nullptr);
+    std::ostream report(saved);
+    {
+        LibraryManager manager(BENCH_FILE);
+        manager.getTotalBooks();
+        manager.searchRecordByID(1);
+
+        report << records << " records, " << std::thread::hardware_concurrency() << " hardware threads"
+               << std::endl;
+        report << std::left << std::setw(22) << "path" << std::setw(12) << "seconds" << "MB/s" << std::endl;
+        report << std::fixed << std::setprecision(2);
+
+        double elapsed = seconds([&] { exportPerRow(manager, records); });
+        report << std::setw(22) << "per-row ostringstream" << std::setw(12) << elapsed
+               << megabytes(CSV_FILE) / elapsed << std::endl;
+
+        for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+            manager.setThreadCount(threads);
+            elapsed = seconds([&] { manager.exportToCSV(CSV_FILE); });
+            report << std::setw(22) << ("exportToCSV x" + std::to_string(threads)) << std::setw(12) << elapsed
+                   << megabytes(CSV_FILE) / elapsed << std::endl;
+        }
+    }
+    std::cout.rdbuf(saved);
+
+    std::remove(CSV_FILE);
+    std::remove(BENCH_FILE);
+    std::remove((std::string(BENCH_FILE) + ".journal").c_str());
+    return 0;
+}
@@ -0,0 +1,104 @@
+// Benchmark: CSV import throughput at different thread counts.
+//
+// Usage: bench_csv_import [rows] [maxThreads]
+//        (defaults 2000000 and std::thread::hardware_concurrency())
+//
+// Writes a feed with quoted fields (embedded commas, quotes and line
+// breaks), rows with an invalid year or ISBN and repeated ISBNs, then
+// imports it into an empty catalog with 1, 2, 4, ... maxThreads threads.
+// Every run must import and reject the same number of rows.
+
+#include "LibraryManager.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+const char* CSV_FILE = "bench_csv_import.csv";
+const char* BENCH_FILE = "bench_csv_import.bin";
+
+uint32_t scramble(uint32_t value) {
+    value ^= value >> 16;
+    value *= 0x45d9f3bu;
+    value ^= value >> 16;
+    return value;
+}
+
+// A valid ISBN-13 for number
+std::string isbnFor(long number) {
+    std::string digits = "978" + std::to_string(1000000000L + number % 1000000000L).substr(1);
+    int sum = 0;
+    for (size_t i = 0; i < 12; ++i) {
+        sum += (digits[i] - '0') * (i % 2 ? 3 : 1);
+    }
+    return digits + static_cast<char>('0' + (10 - sum % 10) % 10);
+}
+
+void writeFeed(long rows) {
+    std::ofstream out(CSV_FILE, std::ios::binary);
+    out << "ID,Title,Author,Year,ISBN,Category,Status\n";
+    for (long row = 1; row <= rows; ++row) {
+        uint32_t r = scramble(static_cast<uint32_t>(row));
+        out << row << ',';
+        switch (r % 8) {
+            case 0:
+                out << "\"Title " << r % 100000 << ", Volume " << r % 7 << "\",";
+                break;
+            case 1:
+                out << "\"The \"\"Quoted\"\" Title " << r % 100000 << "\",";
+                break;
+            case 2:
+                out << "\"A Title on\nTwo Lines " << r % 100000 << "\",";
+                break;
+            default:
+                out << "Title " << r % 100000 << ",";
+        }
+        out << "\"Author, " << r % 20000 << "\",";
+        out << (row % 97 == 0 ? 999 : 1500 + static_cast<int>((r >> 12) % 525)) << ',';
+        if (row % 89 == 0) {
+            out << "978-0000000000";  // bad check digit
+        } else {
+            out << isbnFor(row % 101 == 0 ? row - 1 : row);  // every 101st repeats the previous ISBN
+        }
+        out << ",Fiction," << ((r >> 20) % 4 ? "Available" : "Borrowed") << "\r\n";
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    long rows = argc > 1 ? std::stol(argv[1]) : 2000000;
+    unsigned maxThreads = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2]))
+                                   : std::max(1u, std::thread::hardware_concurrency());
+
+    writeFeed(rows);
+    std::cout << rows << " rows, " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        std::remove(BENCH_FILE);
+        std::remove((std::string(BENCH_FILE) + ".journal").c_str());
+        std::cout << threads << " threads: ";
+        {
+            LibraryManager manager(BENCH_FILE);
+            manager.setStringArena(true);
+            manager.setThreadCount(threads);
+            CsvImporter::Summary summary;
+            manager.importFromCSV(CSV_FILE, &summary);
+            std::cout << summary.rowsImported << " of " << summary.rowsRead << " rows imported in "
+                      << static_cast<long>(summary.seconds * 1000) << " ms ("
+                      << static_cast<long>(summary.rowsRead / summary.seconds) << " rows/sec); "
+                      << summary.rowsRejected << " rejected" << std::endl;
+        }
+    }
+
+    std::remove(CSV_FILE);
+    std::remove(BENCH_FILE);
+    std::remove((std::string(BENCH_FILE) + ".journal").c_str());
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Benchmark: loading books into PostgreSQL one row at a time and in bulk.
+//
+// Usage: bench_db_bulk "conninfo" [records]   (default 100000)
+//        e.g. bench_db_bulk "host=/tmp port=54329 dbname=library_test"
+//
+// DELETES EVERY BOOK in the target database. Inserts records books with
+// insertBook (capped at 10000, one round trip each), insertBooks over a
+// pipeline, and insertBooks with binary COPY, emptying the table between
+// methods, then updates them all with updateBooks. Reports rows/sec for
+// each. Needs a build with libpq.
+
+#include "DatabaseManager.h"
+#include "CatalogFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* EMPTY_FILE = "bench_db_bulk_empty.bin";
+const long SINGLE_ROW_LIMIT = 10000;
+
+std::vector<Book> makeBooks(long records) {
+    std::vector<Book> books;
+    books.reserve(records);
+    for (long i = 0; i < records; ++i) {
+        books.emplace_back(0, "Title " + std::to_string(i), "Author " + std::to_string(i % 5000),
+                           1900 + i % 120, std::to_string(9780000000000LL + i), "Fiction");
+    }
+    return books;
+}
+
+// Rows per second of load over rows books, or -1 if it failed
+double rate(long rows, const std::function<bool()>& load) {
+    auto start = std::chrono::steady_clock::now();
+    if (!load()) {
+        return -1;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return rows / std::chrono::duration<double>(elapsed).count();
+}
+
+void printRate(const char* method, long rows, double rowsPerSecond, DatabaseManager& database) {
+    std::cout << std::setw(20) << method << std::setw(12) << rows;
+    if (rowsPerSecond < 0) {
+        std::cout << "failed: " << database.getLastError() << std::endl;
+    } else {
+        std::cout << std::fixed << std::setprecision(0) << rowsPerSecond << std::endl;
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " \"conninfo\" [records]" << std::endl;
+        return 2;
+    }
+    long records = argc > 2 ? std::stol(argv[2]) : 100000;
+    std::unique_ptr<DatabaseManager> database = DatabaseManager::fromConnectionString(argv[1]);
+    if (!database->connect()) {
+        std::cerr << "Cannot connect: " << database->getLastError() << std::endl;
+        return 1;
+    }
+
+    std::vector<Book> books = makeBooks(records);
+    // Restoring an empty data file empties the table in one statement
+    CatalogFile::write(EMPTY_FILE, std::vector<Book>(), 1);
+    auto empty = [&] {
+        if (!database->restore(EMPTY_FILE)) {
+            std::cerr << "Cannot empty the table: " << database->getLastError() << std::endl;
+        }
+    };
+
+    std::cout << std::left << std::setw(20) << "method" << std::setw(12) << "rows" << "rows/sec" << std::endl;
+
+    empty();
+    long single = std::min(records, SINGLE_ROW_LIMIT);
+    printRate("insertBook", single, rate(single, [&] {
+        for (long i = 0; i < single; ++i) {
+            if (!database->insertBook(books[i])) {
+                return false;
+            }
+        }
+        return true;
+    }), *database);
+
+    empty();
+    printRate("pipeline", records, rate(records, [&] {
+        return database->insertBooks(books, nullptr, DatabaseManager::BulkMethod::Pipeline);
+    }), *database);
+
+    empty();
+    std::vector<int> ids;
+    printRate("copy", records, rate(records, [&] {
+        return database->insertBooks(books, &ids, DatabaseManager::BulkMethod::Copy);
+    }), *database);
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+        books[i].setId(ids[i]);
+        books[i].setAvailability(i % 2 == 0);
+    }
+    printRate("updateBooks", static_cast<long>(ids.size()), rate(static_cast<long>(ids.size()), [&] {
+        return database->updateBooks(books);
+    }), *database);
+
+    empty();
+    std::remove(EMPTY_FILE);
+    return 0;
+}
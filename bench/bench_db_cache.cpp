@@ -0,0 +1,91 @@
+// Benchmark: DatabaseManager lookups with and without the read-through cache.
+//
+// Usage: bench_db_cache "conninfo" [records] [lookups]   (defaults 10000 and 100000)
+//
+// REPLACES EVERY BOOK in the target database with records generated ones,
+// then looks books up by ID, nine in ten among a hot set of 1% of them,
+// and runs a few title searches over and over. Each workload runs with the
+// caches off and then on; reports lookups/sec and the cache counters.
+// Needs a build with libpq.
+
+#include "DatabaseManager.h"
+#include "CatalogFile.h"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* BENCH_FILE = "bench_db_cache.bin";
+const char* const SEARCHES[] = {"title 1", "TITLE 2", "title 42", "Title 7"};
+
+// Lookups per second of run, which makes count lookups
+double rate(long count, const std::function<void()>& run) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return count / std::chrono::duration<double>(elapsed).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " \"conninfo\" [records] [lookups]" << std::endl;
+        return 2;
+    }
+    int records = argc > 2 ? std::stoi(argv[2]) : 10000;
+    long lookups = argc > 3 ? std::stol(argv[3]) : 100000;
+    std::unique_ptr<DatabaseManager> database = DatabaseManager::fromConnectionString(argv[1]);
+    if (!database->connect()) {
+        std::cerr << "Cannot connect: " << database->getLastError() << std::endl;
+        return 1;
+    }
+
+    std::vector<Book> books;
+    for (int id = 1; id <= records; ++id) {
+        books.emplace_back(id, "Title " + std::to_string(id), "Author " + std::to_string(id % 500), 1900 + id % 120,
+                           std::to_string(9780000000000LL + id), "Fiction");
+    }
+    CatalogFile::write(BENCH_FILE, books, records + 1);
+    if (!database->restore(BENCH_FILE)) {
+        std::cerr << "Cannot load books: " << database->getLastError() << std::endl;
+        return 1;
+    }
+
+    std::cout << std::left << std::setw(10) << "cache" << std::setw(14) << "ids/sec" << std::setw(16)
+              << "searches/sec" << "hits/misses/evictions" << std::endl;
+    for (bool cached : {false, true}) {
+        database->setCacheCapacity(cached ? DatabaseManager::DEFAULT_CACHED_BOOKS : 0,
+                                   cached ? DatabaseManager::DEFAULT_CACHED_SEARCHES : 0);
+        DatabaseManager::CacheStats before = database->getCacheStats();
+
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> any(1, records);
+        std::uniform_int_distribution<int> hot(1, std::max(1, records / 100));
+        double idRate = rate(lookups, [&] {
+            for (long i = 0; i < lookups; ++i) {
+                database->getBookById(i % 10 == 0 ? any(rng) : hot(rng));
+            }
+        });
+        long searches = lookups / 10;
+        double searchRate = rate(searches, [&] {
+            for (long i = 0; i < searches; ++i) {
+                database->searchBooks("title", SEARCHES[i % 4]);
+            }
+        });
+
+        DatabaseManager::CacheStats after = database->getCacheStats();
+        std::cout << std::setw(10) << (cached ? "on" : "off") << std::fixed << std::setprecision(0)
+                  << std::setw(14) << idRate << std::setw(16) << searchRate << after.hits - before.hits << "/"
+                  << after.misses - before.misses << "/" << after.evictions - before.evictions << std::endl;
+    }
+
+    std::remove(BENCH_FILE);
+    return 0;
+}
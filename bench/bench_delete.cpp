@@ -0,0 +1,114 @@
+// Benchmark: deleteRecord as the catalog grows.
+//
+// Usage: bench_delete [maxRecords]   (default 1000000)
+//
+// For each catalog size an in-memory catalog is filled and half of its
+// books deleted in random order, then the rest are listed in catalog order,
+// whole and a page at a time, and a page at a time by title.
+// Reports deletes/sec, which should stay flat as the catalog grows:
+// deleted rows are only marked until a quarter of the catalog is deleted,
+// and then compacted in one pass. Paged listings should grow linearly, as
+// each page carries on from where the previous one began.
+
+#include "LibraryManager.h"
+#include "MemoryStorage.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const size_t PAGE_ROWS = 20;
+
+// Build a valid ISBN-13 from a sequence number
+std::string makeIsbn13(long sequence) {
+    std::string digits = "978" + std::to_string(1000000000L + sequence).substr(1);
+    int sum = 0;
+    for (int i = 0; i < 12; ++i) {
+        sum += (digits[i] - '0') * (i % 2 == 0 ? 1 : 3);
+    }
+    digits += static_cast<char>('0' + (10 - sum % 10) % 10);
+    return digits;
+}
+
+// List every book a page at a time; returns the IDs in listed order
+std::vector<int> listPaged(const LibraryManager& manager) {
+    std::vector<int> listed;
+    for (size_t offset = 0;; offset += PAGE_ROWS) {
+        std::vector<Book*> page = manager.listRecords(offset, PAGE_ROWS);
+        for (const Book* book : page) {
+            listed.push_back(book->getId());
+        }
+        if (page.size() < PAGE_ROWS) {
+            return listed;
+        }
+    }
+}
+
+std::vector<int> listAll(const LibraryManager& manager) {
+    std::vector<int> listed;
+    for (const Book* book : manager.listRecords()) {
+        listed.push_back(book->getId());
+    }
+    return listed;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    long maxRecords = argc > 1 ? std::stol(argv[1]) : 1000000;
+
+    std::cout << std::left << std::setw(12) << "records" << std::setw(14) << "deletes/sec"
+              << std::setw(10) << "list ms" << std::setw(11) << "paged ms" << "title paged ms" << std::endl;
+
+    std::mt19937 random(42);
+    for (long records = 10000; records <= maxRecords; records *= 10) {
+        LibraryManager manager(std::make_unique<MemoryStorage>());
+        std::vector<int> ids;
+        ids.reserve(records);
+        for (long i = 0; i < records; ++i) {
+            int id = 0;
+            manager.addRecord("Title " + std::to_string(i), "Author " + std::to_string(i % 5000),
+                              1900 + i % 120, makeIsbn13(i), "Fiction", &id);
+            ids.push_back(id);
+        }
+        std::shuffle(ids.begin(), ids.end(), random);
+        ids.resize(ids.size() / 2);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int id : ids) {
+            manager.deleteRecord(id);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        std::vector<int> listed = listAll(manager);
+        double listMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        std::vector<int> paged = listPaged(manager);
+        double pagedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        manager.sortByTitle();
+        std::vector<int> byTitle = listAll(manager);
+        start = std::chrono::steady_clock::now();
+        std::vector<int> titlePaged = listPaged(manager);
+        double titlePagedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::setw(12) << records << std::fixed << std::setprecision(0) << std::setw(14)
+                  << (ids.size() / seconds) << std::setprecision(1) << std::setw(10) << listMs
+                  << std::setw(11) << pagedMs << titlePagedMs;
+        if (listed.size() != static_cast<size_t>(records) - ids.size()) {
+            std::cout << "  (listed " << listed.size() << " books)";
+        }
+        if (paged != listed || titlePaged != byTitle) {
+            std::cout << "  (paged listing differs)";
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
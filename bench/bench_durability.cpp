@@ -0,0 +1,85 @@
+// Benchmark: journal commit throughput and latency per durability mode.
+//
+// Usage: bench_durability [opsPerThread] [maxThreads]   (defaults 2000, 4)
+//
+// Threads append borrow/return records to one journal. For each mode and
+// thread count, reports total ops/sec and the 50th/99th percentile latency
+// of a single append (the time until the mode's guarantee holds).
+
+#include "Journal.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* BENCH_FILE = "bench_durability.journal";
+
+struct ModeInfo {
+    Journal::Durability mode;
+    const char* name;
+};
+
+const ModeInfo MODES[] = {
+    {Journal::Durability::None, "none"},
+    {Journal::Durability::Periodic, "periodic"},
+    {Journal::Durability::GroupCommit, "group"},
+    {Journal::Durability::PerOperation, "per-op"},
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int opsPerThread = argc > 1 ? std::stoi(argv[1]) : 2000;
+    int maxThreads = argc > 2 ? std::stoi(argv[2]) : 4;
+
+    std::cout << std::left << std::setw(10) << "mode" << std::setw(9) << "threads"
+              << std::setw(14) << "ops/sec" << std::setw(12) << "p50 us" << "p99 us" << std::endl;
+
+    for (const auto& info : MODES) {
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            std::remove(BENCH_FILE);
+            Journal journal(BENCH_FILE);
+            journal.setDurability(info.mode, std::chrono::milliseconds(100));
+            journal.open();
+
+            std::vector<std::vector<double>> latencies(threads);
+            std::vector<std::thread> workers;
+            auto start = std::chrono::steady_clock::now();
+            for (int t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t] {
+                    latencies[t].reserve(opsPerThread);
+                    for (int i = 0; i < opsPerThread; ++i) {
+                        auto opStart = std::chrono::steady_clock::now();
+                        journal.append(i % 2 ? Journal::Operation::Return : Journal::Operation::Borrow, t * opsPerThread + i);
+                        auto opTime = std::chrono::steady_clock::now() - opStart;
+                        latencies[t].push_back(std::chrono::duration<double, std::micro>(opTime).count());
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            journal.close();
+
+            std::vector<double> all;
+            for (const auto& perThread : latencies) {
+                all.insert(all.end(), perThread.begin(), perThread.end());
+            }
+            std::sort(all.begin(), all.end());
+            double p50 = all[all.size() / 2];
+            double p99 = all[std::min(all.size() - 1, all.size() * 99 / 100)];
+
+            std::cout << std::setw(10) << info.name << std::setw(9) << threads << std::fixed
+                      << std::setprecision(0) << std::setw(14) << (all.size() / seconds)
+                      << std::setprecision(1) << std::setw(12) << p50 << p99 << std::endl;
+        }
+    }
+    std::remove(BENCH_FILE);
+    return 0;
+}
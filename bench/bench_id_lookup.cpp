@@ -0,0 +1,70 @@
+// Benchmark: point lookups by book ID as the catalog grows.
+//
+// Usage: bench_id_lookup [maxRecords]   (default 10000000)
+//
+// For each catalog size a data file is generated, loaded through
+// LibraryManager and probed with random IDs. Every record is touched once
+// before timing so first-touch decoding is not counted. Latency per lookup
+// should stay flat as the catalog grows.
+
+#include "LibraryManager.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+
+namespace {
+
+const char* BENCH_FILE = "bench_id_lookup.bin";
+
+void writeCatalog(int count) {
+    std::ofstream out(BENCH_FILE, std::ios::binary | std::ios::trunc);
+    for (int id = 1; id <= count; ++id) {
+        Book book(id, "Title " + std::to_string(id), "Author " + std::to_string(id % 5000),
+                  1900 + id % 120, std::to_string(9780000000000LL + id), "Fiction");
+        book.writeToFile(out);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    long maxRecords = argc > 1 ? std::stol(argv[1]) : 10000000;
+    const int probes = 1000000;
+
+    std::cout << std::left << std::setw(12) << "records"
+              << std::setw(16) << "ns/lookup" << "hits" << std::endl;
+
+    for (long count = 1000; count <= maxRecords; count *= 10) {
+        writeCatalog(static_cast<int>(count));
+        {
+            std::streambuf* saved = std::cout.rdbuf(nullptr);
+            LibraryManager manager(BENCH_FILE);
+            std::cout.rdbuf(saved);
+
+            for (int id = 1; id <= count; ++id) {
+                manager.searchRecordByID(id);
+            }
+
+            std::mt19937 rng(42);
+            std::uniform_int_distribution<int> pick(1, static_cast<int>(count));
+            long hits = 0;
+
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < probes; ++i) {
+                if (manager.searchRecordByID(pick(rng))) {
+                    ++hits;
+                }
+            }
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            double ns = std::chrono::duration<double, std::nano>(elapsed).count() / probes;
+
+            std::cout << std::setw(12) << count << std::setw(16) << std::fixed
+                      << std::setprecision(1) << ns << hits << std::endl;
+        }
+        std::remove(BENCH_FILE);
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Benchmark: scaling of searches and sorts with the thread count.
+//
+// Usage: bench_parallel [records] [maxThreads]
+//        (defaults 1000000 and std::thread::hardware_concurrency())
+//
+// Runs each operation with 1, 2, 4, ... maxThreads threads on the same
+// catalog and reports milliseconds per operation. Results are identical at
+// every thread count; only the time should change.
+
+#include "LibraryManager.h"
+#include "CatalogFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* BENCH_FILE = "bench_parallel.bin";
+const int REPEATS = 5;
+
+uint32_t scramble(uint32_t value) {
+    value ^= value >> 16;
+    value *= 0x45d9f3bu;
+    value ^= value >> 16;
+    return value;
+}
+
+void writeCatalog(long records) {
+    std::vector<Book> books;
+    books.reserve(records);
+    for (int id = 1; id <= records; ++id) {
+        uint32_t r = scramble(id);
+        books.emplace_back(id, "Title " + std::to_string(r % 100000) + " of the series",
+                           "Author " + std::to_string(r % 20000), 1500 + (r >> 12) % 525,
+                           std::to_string(9780000000000LL + id), "Fiction", (r >> 20) % 4 != 0);
+    }
+    CatalogFile::write(BENCH_FILE, books, static_cast<int>(records) + 1);
+}
+
+// Average milliseconds per call of operation
+double averageMs(const std::function<void()>& operation) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < REPEATS; ++i) {
+        operation();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count() / REPEATS;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    long records = argc > 1 ? std::stol(argv[1]) : 1000000;
+    unsigned maxThreads = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2]))
+                                   : std::max(1u, std::thread::hardware_concurrency());
+    std::remove(BENCH_FILE);
+    writeCatalog(records);
+
+    std::streambuf* saved = std::cout.rdbuf(nullptr);
+    std::ostream report(saved);
+    {
+        LibraryManager manager(BENCH_FILE);
+        manager.searchRecordsByTitle("warm");  // decode records and build the text indexes
+
+        report << records << " records, " << std::thread::hardware_concurrency() << " hardware threads"
+               << std::endl;
+        report << std::left << std::setw(9) << "threads" << std::setw(14) << "scan ms" << std::setw(14)
+               << "trigram ms" << "sortByKeys ms" << std::endl;
+        report << std::fixed << std::setprecision(2);
+
+        for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+            manager.setThreadCount(threads);
+            report << std::setw(9) << threads
+                   << std::setw(14) << averageMs([&] { manager.searchRecordsByTitle("ie"); })
+                   << std::setw(14) << averageMs([&] { manager.searchRecordsByTitle("of the"); })
+                   << averageMs([&] { manager.sortByKeys(&Book::getAuthor, &Book::getYear); }) << std::endl;
+            // Put the catalog back in ID order so every row starts from the same layout
+            manager.sortByKeys(&Book::getId);
+        }
+    }
+    std::cout.rdbuf(saved);
+
+    std::remove(BENCH_FILE);
+    std::remove((std::string(BENCH_FILE) + ".journal").c_str());
+    return 0;
+}
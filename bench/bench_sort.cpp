@@ -0,0 +1,106 @@
+// Benchmark: comparator sort (sortBy with std::function) against the key
+// based sort engine (sortByKeys).
+//
+// Usage: bench_sort [records]   (default 1000000)
+//
+// Each sort starts from the same shuffled catalog. The comparator path
+// compares titles and authors case-sensitively; sortByKeys folds case first,
+// so it does strictly more work per key.
+
+#include "LibraryManager.h"
+#include "CatalogFile.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* BENCH_FILE = "bench_sort.bin";
+
+const char* const WORDS[] = {"Silent", "river", "Garden", "of", "the", "Night", "empire", "Lost",
+                             "winter", "Glass", "city", "Stone", "Memory", "fire", "North"};
+const size_t WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+uint32_t scramble(uint32_t value) {
+    value ^= value >> 16;
+    value *= 0x45d9f3bu;
+    value ^= value >> 16;
+    return value;
+}
+
+void writeCatalog(long records) {
+    std::vector<Book> books;
+    books.reserve(records);
+    for (int id = 1; id <= records; ++id) {
+        uint32_t r = scramble(id);
+        std::string title = std::string(WORDS[r % WORD_COUNT]) + " " + WORDS[(r >> 4) % WORD_COUNT] + " " +
+                            WORDS[(r >> 8) % WORD_COUNT] + " " + std::to_string(r % 1000);
+        books.emplace_back(id, title, "Author " + std::to_string(r % 20000), 1500 + (r >> 12) % 525,
+                           std::to_string(9780000000000LL + id), "Fiction");
+    }
+    CatalogFile::write(BENCH_FILE, books, static_cast<int>(records) + 1);
+}
+
+// Put the catalog back into the same pseudo-random order
+void shuffle(LibraryManager& manager) {
+    manager.sortByKeys([](const Book& book) { return static_cast<int32_t>(scramble(book.getId() * 7919u)); });
+}
+
+double timeMs(LibraryManager& manager, const std::function<void()>& sort) {
+    shuffle(manager);
+    auto start = std::chrono::steady_clock::now();
+    sort();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    long records = argc > 1 ? std::stol(argv[1]) : 1000000;
+    std::remove(BENCH_FILE);
+    writeCatalog(records);
+
+    std::streambuf* saved = std::cout.rdbuf(nullptr);
+    std::ostream report(saved);
+    {
+        LibraryManager manager(BENCH_FILE);
+        manager.sortByKeys(&Book::getId);  // load and decode everything up front
+
+        report << records << " records" << std::endl;
+        report << std::left << std::setw(16) << "key" << std::setw(18) << "comparator ms"
+               << "sortByKeys ms" << std::endl;
+        report << std::fixed << std::setprecision(1);
+
+        report << std::setw(16) << "year"
+               << std::setw(18) << timeMs(manager, [&] {
+                      manager.sortBy([](const Book& a, const Book& b) { return a.getYear() < b.getYear(); });
+                  })
+               << timeMs(manager, [&] { manager.sortByKeys(&Book::getYear); }) << std::endl;
+
+        report << std::setw(16) << "title"
+               << std::setw(18) << timeMs(manager, [&] {
+                      manager.sortBy([](const Book& a, const Book& b) { return a.getTitle() < b.getTitle(); });
+                  })
+               << timeMs(manager, [&] { manager.sortByKeys(&Book::getTitle); }) << std::endl;
+
+        report << std::setw(16) << "author, year"
+               << std::setw(18) << timeMs(manager, [&] {
+                      manager.sortBy([](const Book& a, const Book& b) {
+                          int cmp = a.getAuthor().compare(b.getAuthor());
+                          return cmp != 0 ? cmp < 0 : a.getYear() < b.getYear();
+                      });
+                  })
+               << timeMs(manager, [&] { manager.sortByKeys(&Book::getAuthor, &Book::getYear); }) << std::endl;
+    }
+    std::cout.rdbuf(saved);
+
+    std::remove(BENCH_FILE);
+    std::remove((std::string(BENCH_FILE) + ".journal").c_str());
+    return 0;
+}
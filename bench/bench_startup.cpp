@@ -0,0 +1,69 @@
+// Benchmark: startup cost of opening the catalog data file.
+//
+// Usage: bench_startup [maxRecords]   (default 10000000)
+//
+// For each catalog size, reports the time to construct LibraryManager (map
+// the file), to serve the first ID lookup (row build from the fixed-width
+// index), and to serve the first title search (decodes every record and
+// builds the text indexes). Only the last two grow with the catalog.
+
+#include "LibraryManager.h"
+#include "CatalogFile.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* BENCH_FILE = "bench_startup.bin";
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    long maxRecords = argc > 1 ? std::stol(argv[1]) : 10000000;
+
+    std::cout << std::left << std::setw(12) << "records" << std::setw(14) << "open ms"
+              << std::setw(18) << "first lookup ms" << "first search ms" << std::endl;
+
+    for (long count = 1000; count <= maxRecords; count *= 10) {
+        {
+            std::vector<Book> books;
+            books.reserve(count);
+            for (int id = 1; id <= count; ++id) {
+                books.emplace_back(id, "Title " + std::to_string(id), "Author " + std::to_string(id % 5000),
+                                   1900 + id % 120, std::to_string(9780000000000LL + id), "Fiction");
+            }
+            CatalogFile::write(BENCH_FILE, books, static_cast<int>(count) + 1);
+        }
+
+        std::streambuf* saved = std::cout.rdbuf(nullptr);
+        auto start = std::chrono::steady_clock::now();
+        auto manager = std::make_unique<LibraryManager>(BENCH_FILE);
+        double openMs = millisecondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        manager->searchRecordByID(static_cast<int>(count / 2));
+        double lookupMs = millisecondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        manager->searchRecordsByTitle("Title 1");
+        double searchMs = millisecondsSince(start);
+
+        manager.reset();
+        std::cout.rdbuf(saved);
+
+        std::cout << std::setw(12) << count << std::fixed << std::setprecision(3)
+                  << std::setw(14) << openMs << std::setw(18) << lookupMs << searchMs << std::endl;
+        std::remove(BENCH_FILE);
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+// Benchmark: statistics queries as the catalog grows.
+//
+// Usage: bench_statistics [maxRecords]   (default 1000000)
+//
+// For each catalog size a data file is generated and loaded through
+// LibraryManager, then getStatistics and getAvailableBooks are timed
+// between borrows, returns and updates. Counts are maintained as the
+// catalog changes, so query time should depend on the number of distinct
+// authors, categories and decades, not on the number of books.
+
+#include "LibraryManager.h"
+#include "CatalogFile.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* BENCH_FILE = "bench_statistics.bin";
+const int QUERIES = 10000;
+
+const char* const CATEGORIES[] = {"Fiction", "Science", "History", "Poetry", "Travel", "Children"};
+
+void writeCatalog(long records) {
+    std::vector<Book> books;
+    books.reserve(records);
+    for (int id = 1; id <= records; ++id) {
+        books.emplace_back(id, "Title " + std::to_string(id), "Author " + std::to_string(id % 5000),
+                           1800 + id % 225, std::to_string(9780000000000LL + id), CATEGORIES[id % 6],
+                           id % 3 != 0);
+    }
+    CatalogFile::write(BENCH_FILE, books, static_cast<int>(records) + 1);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    long maxRecords = argc > 1 ? std::stol(argv[1]) : 1000000;
+
+    std::cout << std::left << std::setw(12) << "records" << std::setw(18) << "us/statistics"
+              << std::setw(18) << "ns/available" << "borrowed" << std::endl;
+
+    for (long count = 1000; count <= maxRecords; count *= 10) {
+        writeCatalog(count);
+        {
+            LibraryManager manager(BENCH_FILE);
+            manager.setDurability(Journal::Durability::None);
+            manager.getTotalBooks();  // build the catalog rows
+
+            // Mutate between queries so nothing could be answered from a stale result
+            int id = 1;
+            LibraryManager::Statistics stats;
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < QUERIES; ++i) {
+                if (manager.borrowBook(id) != Status::Ok) {
+                    manager.returnBook(id);
+                }
+                id = id % count + 1;
+                stats = manager.getStatistics();
+            }
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            double statisticsUs = std::chrono::duration<double, std::micro>(elapsed).count() / QUERIES;
+
+            LibraryManager::BookUpdate update;
+            update.year = 1999;
+            manager.updateRecord(1, update);
+            long available = 0;
+            start = std::chrono::steady_clock::now();
+            for (int i = 0; i < QUERIES; ++i) {
+                available += manager.getAvailableBooks();
+            }
+            elapsed = std::chrono::steady_clock::now() - start;
+            double availableNs = std::chrono::duration<double, std::nano>(elapsed).count() / QUERIES;
+
+            std::cout << std::setw(12) << count << std::fixed << std::setprecision(2) << std::setw(18)
+                      << statisticsUs << std::setw(18) << availableNs << stats.borrowedBooks << std::endl;
+        }
+        std::remove(BENCH_FILE);
+        std::remove((std::string(BENCH_FILE) + ".journal").c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,398 @@
+// Benchmark: the same workload on every storage engine, checked for
+// conformance and timed.
+//
+// Usage: bench_storage_engines [records] ["conninfo"]   (default 20000)
+//
+// Each engine starts empty, gets records books through addRecord, a CSV
+// import, an update, deletes, and a borrow and return of every book, then
+// checkpoints. A new manager on the same storage must see exactly the
+// books the first one ended with (nothing, for the memory engine). Reports
+// adds/sec, borrows+returns/sec, the checkpoint time and the time to reopen
+// and read every book, and whether the engine conformed; exits non-zero if
+// any did not. The postgres engine runs only with a conninfo, and then
+// DELETES EVERY BOOK in that database.
+//
+// Then every change is tried once more with journal writes made to fail
+// (by capping the file size), under GroupCommit and PerOperation: none may
+// return Ok or show up in the catalog, before or after reopening. Last,
+// every engine with a backing store is given one it cannot use: the file
+// engines a data file from a newer format version, one cut short and a
+// directory in its place; journaled also a journal damaged mid-file and a
+// directory in the journal's place; postgres a server that is not there.
+// Each must fail to open and leave its files as they were. A journal whose
+// last record is torn must still open, without that record.
+
+#include "CatalogFile.h"
+#include "LibraryManager.h"
+#include "PostgresStorage.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/stat.h>
+
+namespace {
+
+const char* BENCH_FILE = "bench_storage_engines.bin";
+const char* IMPORT_FILE = "bench_storage_engines.csv";
+const char* EMPTY_FILE = "bench_storage_engines_empty.bin";
+const char* JOURNAL_FILE = "bench_storage_engines.bin.journal";
+const char* UNREACHABLE_DATABASE = "host=/nonexistent dbname=library_db connect_timeout=1";
+const long IMPORT_ROWS = 1000;
+
+using Row = std::tuple<int, std::string, std::string, int, std::string, std::string, bool>;
+
+struct Result {
+    double addsPerSecond = 0;
+    double changesPerSecond = 0;
+    double checkpointMs = 0;
+    double reopenMs = 0;
+    std::vector<std::string> failures;
+};
+
+// Build a valid ISBN-13 from a sequence number
+std::string makeIsbn13(long sequence) {
+    std::string digits = "978" + std::to_string(1000000000L + sequence).substr(1);
+    int sum = 0;
+    for (int i = 0; i < 12; ++i) {
+        sum += (digits[i] - '0') * (i % 2 == 0 ? 1 : 3);
+    }
+    digits += static_cast<char>('0' + (10 - sum % 10) % 10);
+    return digits;
+}
+
+void writeImportFile(long firstSequence) {
+    std::ofstream out(IMPORT_FILE);
+    out << "Title,Author,Year,ISBN,Category\n";
+    for (long i = 0; i < IMPORT_ROWS; ++i) {
+        out << "Imported " << i << ",Importer " << i % 50 << "," << 1950 + i % 70 << ","
+            << makeIsbn13(firstSequence + i) << ",Imported\n";
+    }
+}
+
+// Every book the manager holds, by ID
+std::vector<Row> contents(LibraryManager& manager) {
+    LibraryManager::Snapshot snapshot = manager.snapshot();
+    std::vector<Row> rows;
+    for (const Book* book : manager.listRecords()) {
+        rows.emplace_back(book->getId(), book->getTitle(), book->getAuthor(), book->getYear(), book->getIsbn(),
+                          book->getCategory(), book->getAvailability());
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Run the workload against storage made by open, which must start empty
+Result run(const std::function<std::unique_ptr<StorageEngine>()>& open, long records) {
+    Result result;
+    auto check = [&result](bool passed, const std::string& what) {
+        if (!passed) {
+            result.failures.push_back(what);
+        }
+    };
+
+    std::vector<Row> expected;
+    bool persistent = true;
+    {
+        LibraryManager manager(open());
+        persistent = manager.getStorageEngine().isPersistent();
+        check(manager.getTotalBooks() == 0, "starts empty");
+
+        std::vector<int> ids;
+        ids.reserve(records);
+        auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < records; ++i) {
+            int id = 0;
+            if (manager.addRecord("Title " + std::to_string(i), "Author " + std::to_string(i % 500),
+                                  1900 + i % 120, makeIsbn13(i), "Fiction", &id) == Status::Ok) {
+                ids.push_back(id);
+            }
+        }
+        result.addsPerSecond = records / secondsSince(start);
+        check(static_cast<long>(ids.size()) == records, "every add succeeds");
+        std::vector<int> sorted = ids;
+        std::sort(sorted.begin(), sorted.end());
+        check(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end(), "new IDs are distinct");
+
+        writeImportFile(records);
+        CsvImporter::Summary summary;
+        check(manager.importFromCSV(IMPORT_FILE, &summary) == Status::Ok &&
+                  summary.rowsImported == static_cast<size_t>(IMPORT_ROWS),
+              "import stores every row");
+
+        if (!ids.empty()) {
+            LibraryManager::BookUpdate update;
+            update.title = "Updated";
+            update.category = "Revised";
+            check(manager.updateRecord(ids.front(), update) == Status::Ok, "update");
+            check(manager.deleteRecord(ids.back()) == Status::Ok, "delete");
+            check(manager.searchRecordByID(ids.back()) == nullptr, "deleted book is gone");
+            ids.pop_back();
+        }
+
+        start = std::chrono::steady_clock::now();
+        size_t changed = 0;
+        for (int id : ids) {
+            changed += manager.borrowBook(id) == Status::Ok;
+        }
+        for (size_t i = 0; i < ids.size(); i += 2) {
+            changed += manager.returnBook(ids[i]) == Status::Ok;
+        }
+        result.changesPerSecond = changed / secondsSince(start);
+        check(changed == ids.size() + (ids.size() + 1) / 2, "every borrow and return succeeds");
+        check(manager.getBorrowedBooks() == static_cast<int>(ids.size() / 2), "borrowed count");
+
+        expected = contents(manager);
+        start = std::chrono::steady_clock::now();
+        check(manager.checkpoint() == Status::Ok, "checkpoint");
+        result.checkpointMs = secondsSince(start) * 1000;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    LibraryManager reopened(open());
+    std::vector<Row> stored = contents(reopened);
+    result.reopenMs = secondsSince(start) * 1000;
+    check(stored == (persistent ? expected : std::vector<Row>()), "reopened catalog matches");
+    return result;
+}
+
+void removeFiles() {
+    for (const std::string& name : {std::string(BENCH_FILE), std::string(JOURNAL_FILE),
+                                    std::string(BENCH_FILE) + ".tmp"}) {
+        std::remove(name.c_str());
+    }
+}
+
+// Whole contents of a file; a directory reads as its name
+std::string readFile(const std::string& filename) {
+    struct stat info;
+    if (stat(filename.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+        return filename + "/";
+    }
+    std::ifstream in(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Replace the data file with one no engine can read: a valid file marked
+// with a newer format version, or one cut short after its header
+void writeBadDataFile(bool newerVersion) {
+    std::vector<Book> books;
+    for (int i = 1; i <= 100; ++i) {
+        books.emplace_back(i, "Title " + std::to_string(i), "Author", 2000, makeIsbn13(i), "Fiction", true);
+    }
+    CatalogFile::write(BENCH_FILE, books, 101);
+    std::string contents = readFile(BENCH_FILE);
+    if (newerVersion) {
+        // The version follows the 8-byte magic
+        uint32_t version = CatalogFile::FORMAT_VERSION + 1;
+        contents.replace(8, sizeof(version), reinterpret_cast<const char*>(&version), sizeof(version));
+    } else {
+        contents.resize(100);
+    }
+    std::ofstream(BENCH_FILE, std::ios::binary | std::ios::trunc) << contents;
+}
+
+// Write a journal of three adds, then damage its first record or tear off
+// the end of its last
+void writeJournal(bool damaged) {
+    {
+        Journal journal(JOURNAL_FILE);
+        journal.open();
+        for (int i = 1; i <= 3; ++i) {
+            journal.append(Journal::Operation::Add,
+                           Book(i, "Journaled " + std::to_string(i), "Author", 2000, makeIsbn13(i), "Fiction", true));
+        }
+    }
+    std::string contents = readFile(JOURNAL_FILE);
+    if (damaged) {
+        // Past the first frame header, inside the book's ID
+        contents[10] ^= 0x5a;
+    } else {
+        contents.resize(contents.size() - 3);
+    }
+    std::ofstream(JOURNAL_FILE, std::ios::binary | std::ios::trunc) << contents;
+}
+
+// Give engine each backing store it must refuse; returns what went wrong
+std::vector<std::string> runBadStores(const std::string& engine) {
+    std::vector<std::string> failures;
+    if (engine == "postgres") {
+        LibraryManager manager(
+            std::make_unique<PostgresStorage>(DatabaseManager::fromConnectionString(UNREACHABLE_DATABASE)));
+        if (manager.isOpen()) {
+            failures.push_back("unreachable server: opens");
+        }
+        return failures;
+    }
+
+    std::vector<std::pair<std::string, std::function<void()>>> stores = {
+        {"newer version", [] { writeBadDataFile(true); }},
+        {"cut short", [] { writeBadDataFile(false); }},
+        {"directory", [] { mkdir(BENCH_FILE, 0755); }},
+    };
+    if (engine == "journaled") {
+        stores.emplace_back("damaged journal", [] { writeJournal(true); });
+        stores.emplace_back("journal directory", [] { mkdir(JOURNAL_FILE, 0755); });
+    }
+    for (const auto& store : stores) {
+        removeFiles();
+        store.second();
+        std::string before = readFile(BENCH_FILE) + readFile(JOURNAL_FILE);
+        {
+            LibraryManager manager(StorageEngine::create(engine, BENCH_FILE));
+            if (manager.isOpen()) {
+                failures.push_back(store.first + ": opens");
+            }
+        }
+        if (readFile(BENCH_FILE) + readFile(JOURNAL_FILE) != before) {
+            failures.push_back(store.first + ": files changed");
+        }
+    }
+
+    if (engine == "journaled") {
+        removeFiles();
+        writeJournal(false);
+        LibraryManager manager(StorageEngine::create(engine, BENCH_FILE));
+        if (!manager.isOpen() || manager.getTotalBooks() != 2) {
+            failures.push_back("torn last record: not recovered");
+        }
+    }
+    return failures;
+}
+
+// Try every change while journal writes fail; returns what went wrong
+std::vector<std::string> runFailedWrites(Journal::Durability mode) {
+    std::vector<std::string> failures;
+    auto check = [&failures](bool passed, const std::string& what) {
+        if (!passed) {
+            failures.push_back(what);
+        }
+    };
+
+    removeFiles();
+    std::vector<Row> expected;
+    {
+        LibraryManager manager(StorageEngine::create("journaled", BENCH_FILE));
+        manager.setDurability(mode);
+        int kept = 0;
+        int borrowed = 0;
+        manager.addRecord("Kept", "Author", 2000, makeIsbn13(1), "Fiction", &kept);
+        manager.addRecord("Borrowed", "Author", 2001, makeIsbn13(2), "Fiction", &borrowed);
+        manager.borrowBook(borrowed);
+        check(manager.checkpoint() == Status::Ok, "checkpoint");
+        expected = contents(manager);
+
+        // Writing past the limit fails with EFBIG instead of raising SIGXFSZ
+        std::signal(SIGXFSZ, SIG_IGN);
+        struct rlimit original;
+        getrlimit(RLIMIT_FSIZE, &original);
+        struct rlimit capped = original;
+        capped.rlim_cur = 0;
+        setrlimit(RLIMIT_FSIZE, &capped);
+
+        LibraryManager::BookUpdate update;
+        update.title = "Updated";
+        check(manager.addRecord("Added", "Author", 2002, makeIsbn13(3), "Fiction") != Status::Ok, "add fails");
+        check(manager.updateRecord(kept, update) != Status::Ok, "update fails");
+        check(manager.deleteRecord(kept) != Status::Ok, "delete fails");
+        check(manager.borrowBook(kept) != Status::Ok, "borrow fails");
+        check(manager.returnBook(borrowed) != Status::Ok, "return fails");
+        check(contents(manager) == expected, "catalog unchanged");
+        check(manager.getBorrowedBooks() == 1, "borrowed count unchanged");
+
+        setrlimit(RLIMIT_FSIZE, &original);
+        check(manager.borrowBook(kept) == Status::Ok, "journal usable again");
+        expected = contents(manager);
+    }
+    LibraryManager reopened(StorageEngine::create("journaled", BENCH_FILE));
+    check(contents(reopened) == expected, "reopened catalog matches");
+    return failures;
+}
+
+// Print pass, or what failed; true for pass
+bool printOutcome(const std::vector<std::string>& failures) {
+    if (failures.empty()) {
+        std::cout << "pass" << std::endl;
+        return true;
+    }
+    std::cout << "FAIL:";
+    for (const std::string& failure : failures) {
+        std::cout << " [" << failure << "]";
+    }
+    std::cout << std::endl;
+    return false;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    long records = argc > 1 ? std::stol(argv[1]) : 20000;
+    std::string connectionString = argc > 2 ? argv[2] : "";
+
+    std::cout << std::left << std::setw(11) << "engine" << std::setw(12) << "adds/sec" << std::setw(15)
+              << "changes/sec" << std::setw(15) << "checkpoint ms" << std::setw(12) << "reopen ms"
+              << "conformance" << std::endl;
+
+    bool allPassed = true;
+    for (const std::string& engine : StorageEngine::engineNames()) {
+        std::function<std::unique_ptr<StorageEngine>()> open;
+        if (engine == "postgres") {
+            if (connectionString.empty()) {
+                std::cout << std::setw(11) << engine << "skipped (no conninfo)" << std::endl;
+                continue;
+            }
+            std::shared_ptr<DatabaseManager> database = DatabaseManager::fromConnectionString(connectionString);
+            // Restoring an empty data file empties the table in one statement
+            CatalogFile::write(EMPTY_FILE, std::vector<Book>(), 1);
+            if (!database->connect() || !database->restore(EMPTY_FILE)) {
+                std::cout << std::setw(11) << engine << "cannot empty the database: " << database->getLastError()
+                          << std::endl;
+                allPassed = false;
+                continue;
+            }
+            open = [database] { return std::make_unique<PostgresStorage>(database); };
+        } else {
+            removeFiles();
+            open = [engine] { return StorageEngine::create(engine, BENCH_FILE); };
+        }
+
+        Result result = run(open, records);
+        std::cout << std::setw(11) << engine << std::fixed << std::setprecision(0) << std::setw(12)
+                  << result.addsPerSecond << std::setw(15) << result.changesPerSecond << std::setprecision(1)
+                  << std::setw(15) << result.checkpointMs << std::setw(12) << result.reopenMs;
+        allPassed = printOutcome(result.failures) && allPassed;
+    }
+
+    for (Journal::Durability mode : {Journal::Durability::GroupCommit, Journal::Durability::PerOperation}) {
+        std::vector<std::string> failures = runFailedWrites(mode);
+        std::cout << "failed journal writes, "
+                  << (mode == Journal::Durability::GroupCommit ? "group commit: " : "per operation: ");
+        allPassed = printOutcome(failures) && allPassed;
+    }
+
+    for (const std::string& engine : StorageEngine::engineNames()) {
+        if (engine == "memory") {
+            continue;
+        }
+        std::vector<std::string> failures = runBadStores(engine);
+        std::cout << "unusable store, " << engine << ": ";
+        allPassed = printOutcome(failures) && allPassed;
+    }
+
+    removeFiles();
+    std::remove(IMPORT_FILE);
+    std::remove(EMPTY_FILE);
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+// Benchmark: heap allocations and time to load a catalog's strings, with
+// and without the string arena.
+//
+// Usage: bench_string_arena [records]   (default 1000000)
+//
+// Writes a catalog, opens it and decodes every record (ID lookups in order),
+// once with titles and ISBNs allocated one heap block each and once from
+// LibraryManager's monotonic arena. Allocations are counted by replacing the
+// global operator new; the count includes the catalog rows and indexes, which
+// are the same in both modes.
+
+#include "LibraryManager.h"
+#include "CatalogFile.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* BENCH_FILE = "bench_string_arena.bin";
+
+std::atomic<long> allocationCount(0);
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+// Titles longer than the small-string buffer, as most real titles are
+void writeCatalog(long records) {
+    std::vector<Book> books;
+    books.reserve(records);
+    for (int id = 1; id <= records; ++id) {
+        books.emplace_back(id, "The Collected Works, Volume " + std::to_string(id),
+                           "Author " + std::to_string(id % 5000), 1900 + id % 120,
+                           std::to_string(9780000000000LL + id), "Fiction");
+    }
+    CatalogFile::write(BENCH_FILE, books, static_cast<int>(records) + 1);
+}
+
+void loadAll(bool useArena, long records, std::ostream& report) {
+    long allocationsBefore = allocationCount.load();
+    auto start = std::chrono::steady_clock::now();
+    {
+        LibraryManager manager(BENCH_FILE);
+        manager.setStringArena(useArena);
+        for (int id = 1; id <= records; ++id) {
+            manager.searchRecordByID(id);
+        }
+        double loadMs = millisecondsSince(start);
+        long allocations = allocationCount.load() - allocationsBefore;
+        report << std::setw(8) << (useArena ? "arena" : "heap") << std::setw(14) << allocations
+               << std::fixed << std::setprecision(1) << loadMs << std::endl;
+    }
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* block = std::malloc(size ? size : 1)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+// std::pmr::new_delete_resource() allocates through the aligned overloads
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if (void* block = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept {
+    std::free(block);
+}
+
+int main(int argc, char* argv[]) {
+    long records = argc > 1 ? std::stol(argv[1]) : 1000000;
+    std::remove(BENCH_FILE);
+    writeCatalog(records);
+
+    std::streambuf* savedOut = std::cout.rdbuf(nullptr);
+    std::ostream report(savedOut);
+    report << records << " records" << std::endl;
+    report << std::left << std::setw(8) << "strings" << std::setw(14) << "allocations" << "load ms" << std::endl;
+    loadAll(false, records, report);
+    loadAll(true, records, report);
+    std::cout.rdbuf(savedOut);
+
+    std::remove(BENCH_FILE);
+    std::remove((std::string(BENCH_FILE) + ".journal").c_str());
+    return 0;
+}
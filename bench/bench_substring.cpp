@@ -0,0 +1,86 @@
+// Benchmark: case-insensitive substring matching over catalog titles.
+//
+// Usage: bench_substring [titles]   (default 200000)
+//
+// Compares the original lowercase-copy + std::string::find approach with each
+// StringSearch kernel the CPU supports. Match counts must agree across rows.
+
+#include "StringSearch.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* WORDS[] = {"The", "Great", "history", "OF", "Modern", "science", "Garden", "secret",
+                       "Programming", "Ocean", "winter", "Silent", "Kingdom", "c++", "Data", "and"};
+
+std::vector<std::string> makeTitles(size_t count) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<size_t> word(0, sizeof(WORDS) / sizeof(WORDS[0]) - 1);
+    std::uniform_int_distribution<int> length(2, 8);
+    std::vector<std::string> titles(count);
+    for (auto& title : titles) {
+        int words = length(rng);
+        for (int w = 0; w < words; ++w) {
+            if (w > 0) {
+                title += ' ';
+            }
+            title += WORDS[word(rng)];
+        }
+    }
+    return titles;
+}
+
+template <typename Match>
+void report(const std::string& name, const std::vector<std::string>& titles,
+            const std::string& query, Match match) {
+    auto start = std::chrono::steady_clock::now();
+    size_t hits = 0;
+    for (const auto& title : titles) {
+        if (match(title, query)) {
+            ++hits;
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double ms = std::chrono::duration<double, std::milli>(elapsed).count();
+    std::cout << std::setw(10) << name << std::setw(12) << std::fixed << std::setprecision(2)
+              << ms << hits << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 200000;
+    std::vector<std::string> titles = makeTitles(count);
+    const std::string queries[] = {"e", "da", "gar", "kingdom", "programming of", "zzz"};
+
+    std::cout << "active kernel: " << StringSearch::kernelName(StringSearch::activeKernel()) << "\n";
+    for (const auto& query : queries) {
+        std::cout << "\nquery '" << query << "' over " << count << " titles\n";
+        std::cout << std::left << std::setw(10) << "kernel" << std::setw(12) << "ms" << "hits" << std::endl;
+
+        report("baseline", titles, query, [](const std::string& title, const std::string& needle) {
+            std::string lowerTitle = title;
+            std::transform(lowerTitle.begin(), lowerTitle.end(), lowerTitle.begin(), ::tolower);
+            std::string lowerNeedle = needle;
+            std::transform(lowerNeedle.begin(), lowerNeedle.end(), lowerNeedle.begin(), ::tolower);
+            return lowerTitle.find(lowerNeedle) != std::string::npos;
+        });
+
+        for (auto kernel : {StringSearch::Kernel::Scalar, StringSearch::Kernel::SSE2, StringSearch::Kernel::AVX2}) {
+            if (!StringSearch::isSupported(kernel)) {
+                continue;
+            }
+            report(StringSearch::kernelName(kernel), titles, query,
+                   [kernel](const std::string& title, const std::string& needle) {
+                       return StringSearch::containsIgnoreCase(kernel, title, needle);
+                   });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Benchmark: listing the whole catalog as a table.
+//
+// Usage: bench_table [records]   (default 1000000)
+//
+// Compares the former per-cell std::setw output with an std::endl per row
+// against TableRenderer, which builds the table in one buffer. Output
+// goes to /dev/null, so this measures formatting and write calls, not the
+// terminal.
+
+#include "LibraryManager.h"
+#include "CatalogFile.h"
+#include "TableRenderer.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* BENCH_FILE = "bench_table.bin";
+
+uint32_t scramble(uint32_t value) {
+    value ^= value >> 16;
+    value *= 0x45d9f3bu;
+    value ^= value >> 16;
+    return value;
+}
+
+void writeCatalog(long records) {
+    std::vector<Book> books;
+    books.reserve(records);
+    for (int id = 1; id <= records; ++id) {
+        uint32_t r = scramble(id);
+        books.emplace_back(id, "Title " + std::to_string(r % 100000) + " of the long running series",
+                           "Author " + std::to_string(r % 20000), 1500 + (r >> 12) % 525,
+                           std::to_string(9780000000000LL + id), "Fiction", (r >> 20) % 4 != 0);
+    }
+    CatalogFile::write(BENCH_FILE, books, static_cast<int>(records) + 1);
+}
+
+// The listing loop as it was: setw per cell, std::endl per row
+void displayPerCell(LibraryManager& manager, long records) {
+    for (int id = 1; id <= records; ++id) {
+        const Book* book = manager.searchRecordByID(id);
+        std::cout << std::left << std::setw(5) << book->getId()
+                  << std::setw(25) << book->getTitle()
+                  << std::setw(20) << book->getAuthor()
+                  << std::setw(6) << book->getYear()
+                  << std::setw(15) << book->getIsbn()
+                  << std::setw(15) << book->getCategory()
+                  << std::setw(10) << (book->getAvailability() ? "Available" : "Borrowed")
+                  << std::endl;
+    }
+}
+
+// The listing as the menu renders it
+void displayBuffered(LibraryManager& manager) {
+    TableRenderer table(std::cout);
+    table.addHeader();
+    for (const Book* book : manager.listRecords()) {
+        table.addRow(*book);
+    }
+}
+
+double seconds(const std::function<void()>& operation) {
+    auto start = std::chrono::steady_clock::now();
+    operation();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    long records = argc > 1 ? std::stol(argv[1]) : 1000000;
+    std::remove(BENCH_FILE);
+    writeCatalog(records);
+
+    std::ofstream devNull("/dev/null");
+    std::streambuf* saved = std::cout.rdbuf(devNull.rdbuf());
+    std::ostream report(saved);
+    {
+        LibraryManager manager(BENCH_FILE);
+        manager.listRecords();  // decode every record first
+
+        report << records << " records" << std::endl;
+        report << std::fixed << std::setprecision(3);
+        report << "per-cell setw + endl: " << seconds([&] { displayPerCell(manager, records); }) << " s"
+               << std::endl;
+        report << "TableRenderer:        " << seconds([&] { displayBuffered(manager); }) << " s" << std::endl;
+    }
+    std::cout.rdbuf(saved);
+
+    std::remove(BENCH_FILE);
+    std::remove((std::string(BENCH_FILE) + ".journal").c_str());
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include "AvailabilityBitmap.h"
+#include <algorithm>
+
+// Constructor
+AvailabilityBitmap::AvailabilityBitmap() : capacity(0), slots(0), waiters(new Waiters[WAITER_STRIPES]) {}
+
+// Reallocate to hold at least minimumWords words, keeping the contents
+void AvailabilityBitmap::grow(size_t minimumWords) {
+    size_t newCapacity = std::max(minimumWords, capacity * 2);
+    std::unique_ptr<std::atomic<uint64_t>[]> grown(new std::atomic<uint64_t>[newCapacity]);
+    for (size_t i = 0; i < newCapacity; ++i) {
+        grown[i].store(i < capacity ? words[i].load(std::memory_order_relaxed) : 0, std::memory_order_relaxed);
+    }
+    words.swap(grown);
+    capacity = newCapacity;
+}
+
+// Remove all slots
+void AvailabilityBitmap::clear() {
+    for (size_t i = 0; i < capacity; ++i) {
+        words[i].store(0, std::memory_order_relaxed);
+    }
+    slots = 0;
+}
+
+// Make room for count slots
+void AvailabilityBitmap::reserve(size_t count) {
+    size_t needed = (count + SLOTS_PER_WORD - 1) / SLOTS_PER_WORD;
+    if (needed > capacity) {
+        grow(needed);
+    }
+}
+
+// Add a new last slot
+void AvailabilityBitmap::append(bool available) {
+    if (slots == capacity * SLOTS_PER_WORD) {
+        grow(capacity + 1);
+    }
+    if (available) {
+        wordOf(slots).fetch_or(availableBit(slots), std::memory_order_relaxed);
+    }
+    ++slots;
+}
+
+// Remove slot, shifting later slots down by one. Slots past the end are
+// kept clear, so the last word's top slot takes in zero.
+void AvailabilityBitmap::erase(size_t slot) {
+    size_t first = slot / SLOTS_PER_WORD;
+    size_t last = (slots - 1) / SLOTS_PER_WORD;
+    for (size_t i = first; i <= last; ++i) {
+        uint64_t word = words[i].load(std::memory_order_relaxed);
+        uint64_t carry = i < last ? (words[i + 1].load(std::memory_order_relaxed) & 3) << 62 : 0;
+        if (i == first) {
+            size_t shift = 2 * (slot % SLOTS_PER_WORD);
+            uint64_t below = word & ((1ULL << shift) - 1);
+            uint64_t above = shift + 2 < 64 ? (word >> (shift + 2)) << shift : 0;
+            word = below | above;
+        } else {
+            word >>= 2;
+        }
+        words[i].store(word | carry, std::memory_order_relaxed);
+    }
+    --slots;
+}
+
+// Apply a slot permutation
+void AvailabilityBitmap::permute(const std::vector<size_t>& order) {
+    std::vector<uint64_t> reordered(capacity, 0);
+    for (size_t slot = 0; slot < order.size(); ++slot) {
+        if (test(order[slot])) {
+            reordered[slot / SLOTS_PER_WORD] |= availableBit(slot);
+        }
+    }
+    for (size_t i = 0; i < capacity; ++i) {
+        words[i].store(reordered[i], std::memory_order_relaxed);
+    }
+    slots = order.size();
+}
+
+// Set the availability of a slot no one else is using
+void AvailabilityBitmap::set(size_t slot, bool available) {
+    if (available) {
+        wordOf(slot).fetch_or(availableBit(slot), std::memory_order_release);
+    } else {
+        wordOf(slot).fetch_and(~availableBit(slot), std::memory_order_release);
+    }
+}
+
+// Flip slot to available and mark it busy, in one compare-and-swap
+bool AvailabilityBitmap::claim(size_t slot, bool available) {
+    std::atomic<uint64_t>& word = wordOf(slot);
+    uint64_t bit = availableBit(slot);
+    uint64_t busy = busyBit(slot);
+    uint64_t current = word.load(std::memory_order_acquire);
+    while (true) {
+        if (current & busy) {
+            waitWhileBusy(slot);
+            current = word.load(std::memory_order_acquire);
+            continue;
+        }
+        if (((current & bit) != 0) == available) {
+            return false;
+        }
+        uint64_t changed = (available ? current | bit : current & ~bit) | busy;
+        if (word.compare_exchange_weak(current, changed, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return true;
+        }
+    }
+}
+
+// Mark a claimed slot as no longer busy
+void AvailabilityBitmap::release(size_t slot) {
+    wordOf(slot).fetch_and(~busyBit(slot), std::memory_order_seq_cst);
+    wakeWaiters(slot);
+}
+
+// Flip a claimed slot back and mark it no longer busy
+void AvailabilityBitmap::revert(size_t slot) {
+    wordOf(slot).fetch_xor(availableBit(slot) | busyBit(slot), std::memory_order_seq_cst);
+    wakeWaiters(slot);
+}
+
+// Sleep until slot is no longer busy. The waiter is counted before the
+// busy bit is checked, and a releaser clears the bit before reading the
+// count, so either the check sees the bit clear or the releaser wakes it.
+void AvailabilityBitmap::waitWhileBusy(size_t slot) {
+    Waiters& stripe = waitersOf(slot);
+    std::unique_lock<std::mutex> lock(stripe.mutex);
+    stripe.count.fetch_add(1, std::memory_order_seq_cst);
+    stripe.released.wait(lock, [this, slot] {
+        return (wordOf(slot).load(std::memory_order_seq_cst) & busyBit(slot)) == 0;
+    });
+    stripe.count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// Wake claims sleeping on slot's stripe, if there are any
+void AvailabilityBitmap::wakeWaiters(size_t slot) {
+    Waiters& stripe = waitersOf(slot);
+    if (stripe.count.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        stripe.released.notify_all();
+    }
+}
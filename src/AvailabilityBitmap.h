@@ -0,0 +1,76 @@
+#ifndef AVAILABILITY_BITMAP_H
+#define AVAILABILITY_BITMAP_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Availability of every catalog slot, packed two bits per slot into atomic
+// 64-bit words: whether the book is available, and whether a borrow or
+// return of it is still being recorded.
+//
+// Borrow and return claim a slot with one compare-and-swap that flips its
+// availability and marks it busy, record the change, then clear the busy
+// bit. Changes to different slots never wait for each other, and changes
+// to one slot are recorded in the order their compare-and-swaps succeeded.
+// Recording can wait on a sync or a database round trip, so a claim of a
+// busy slot sleeps until the slot is released rather than spinning.
+//
+// claim, release, revert and test are safe from any thread. The other
+// methods resize or reorder the bitmap and need every other user held off.
+class AvailabilityBitmap {
+private:
+    static const size_t SLOTS_PER_WORD = 32;
+
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+    size_t capacity;  // words allocated
+    size_t slots;
+
+    // Claims sleeping on busy slots, which share these by slot number
+    struct Waiters {
+        std::mutex mutex;
+        std::condition_variable released;
+        std::atomic<size_t> count{0};
+    };
+    static const size_t WAITER_STRIPES = 64;
+    std::unique_ptr<Waiters[]> waiters;
+
+    static uint64_t availableBit(size_t slot) { return 1ULL << (2 * (slot % SLOTS_PER_WORD)); }
+    static uint64_t busyBit(size_t slot) { return availableBit(slot) << 1; }
+    std::atomic<uint64_t>& wordOf(size_t slot) const { return words[slot / SLOTS_PER_WORD]; }
+    Waiters& waitersOf(size_t slot) const { return waiters[slot % WAITER_STRIPES]; }
+    void grow(size_t minimumWords);
+    void waitWhileBusy(size_t slot);
+    void wakeWaiters(size_t slot);
+
+public:
+    // Constructor
+    AvailabilityBitmap();
+
+    size_t size() const { return slots; }
+    void clear();
+    void reserve(size_t count);
+    void append(bool available);
+    void erase(size_t slot);
+    // Reorder so that new slot i holds what was in slot order[i]; slots
+    // missing from order are dropped
+    void permute(const std::vector<size_t>& order);
+
+    bool test(size_t slot) const { return (wordOf(slot).load(std::memory_order_acquire) & availableBit(slot)) != 0; }
+    // Set a slot no one else is using
+    void set(size_t slot, bool available);
+
+    // Make slot available (or not) and mark it busy until release. False,
+    // with nothing changed, if it already was; waits while another change
+    // to the slot is being recorded.
+    bool claim(size_t slot, bool available);
+    void release(size_t slot);
+    // Undo a claim whose change could not be recorded, and release the slot
+    void revert(size_t slot);
+};
+
+#endif // AVAILABILITY_BITMAP_H
@@ -0,0 +1,214 @@
+#include "BatchRunner.h"
+#include "CsvFormat.h"
+#include <charconv>
+#include <chrono>
+
+// Constructor
+BatchRunner::BatchRunner(LibraryManager& manager) : manager(manager), fieldCount(0) {}
+
+// Check the command has between min and max fields, the name included
+bool BatchRunner::expectFields(size_t min, size_t max, std::string& error) const {
+    if (fieldCount < min || fieldCount > max) {
+        error = fields[0] + ": expected " + std::to_string(min - 1) +
+                (max > min ? "-" + std::to_string(max - 1) : std::string()) + " arguments, found " +
+                std::to_string(fieldCount - 1);
+        return false;
+    }
+    return true;
+}
+
+// Parse text as an integer
+bool BatchRunner::readInt(const std::string& text, int& value, std::string& error) const {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (text.empty() || result.ec != std::errc() || result.ptr != text.data() + text.size()) {
+        error = fields[0] + ": '" + text + "' is not a number";
+        return false;
+    }
+    return true;
+}
+
+// Add one <field>=<value> of an update command to update
+bool BatchRunner::readUpdate(const std::string& assignment, LibraryManager::BookUpdate& update,
+                             std::string& error) const {
+    size_t equals = assignment.find('=');
+    if (equals == std::string::npos) {
+        error = "update: expected <field>=<value>, found '" + assignment + "'";
+        return false;
+    }
+    std::string name = assignment.substr(0, equals);
+    std::string value = assignment.substr(equals + 1);
+    if (name == "title") {
+        update.title = value;
+    } else if (name == "author") {
+        update.author = value;
+    } else if (name == "year") {
+        int year = 0;
+        if (!readInt(value, year, error)) {
+            return false;
+        }
+        update.year = year;
+    } else if (name == "isbn") {
+        update.isbn = value;
+    } else if (name == "category") {
+        update.category = value;
+    } else {
+        error = "update: unknown field '" + name + "' (expected title, author, year, isbn or category)";
+        return false;
+    }
+    return true;
+}
+
+// Report a failed library operation as error
+bool BatchRunner::check(Status status, std::string& error) const {
+    if (status != Status::Ok) {
+        error = fields[0] + ": " + statusMessage(status);
+        return false;
+    }
+    return true;
+}
+
+// Run the command in fields
+bool BatchRunner::execute(Summary& summary, std::string& error) {
+    const std::string& command = fields[0];
+    int number = 0;
+    
+    if (command == "add") {
+        if (!expectFields(5, 6, error) || !readInt(fields[3], number, error)) {
+            return false;
+        }
+        return check(manager.addRecord(fields[1], fields[2], number, fields[4],
+                                       fieldCount > 5 ? fields[5] : std::string()), error);
+    }
+    if (command == "update") {
+        if (!expectFields(3, 7, error) || !readInt(fields[1], number, error)) {
+            return false;
+        }
+        LibraryManager::BookUpdate update;
+        for (size_t field = 2; field < fieldCount; ++field) {
+            if (!readUpdate(fields[field], update, error)) {
+                return false;
+            }
+        }
+        return check(manager.updateRecord(number, update), error);
+    }
+    if (command == "delete" || command == "borrow" || command == "return" || command == "search-id") {
+        if (!expectFields(2, 2, error) || !readInt(fields[1], number, error)) {
+            return false;
+        }
+        if (command == "delete") {
+            return check(manager.deleteRecord(number), error);
+        }
+        if (command == "borrow") {
+            return check(manager.borrowBook(number), error);
+        }
+        if (command == "return") {
+            return check(manager.returnBook(number), error);
+        }
+        summary.matches += manager.searchRecordByID(number) ? 1 : 0;
+        return true;
+    }
+    if (command == "search-isbn") {
+        if (!expectFields(2, 2, error)) {
+            return false;
+        }
+        summary.matches += manager.searchRecordByISBN(fields[1]) ? 1 : 0;
+        return true;
+    }
+    if (command == "search-title" || command == "search-author") {
+        if (!expectFields(2, 2, error)) {
+            return false;
+        }
+        summary.matches += command == "search-title" ? manager.searchRecordsByTitle(fields[1]).size()
+                                                     : manager.searchRecordsByAuthor(fields[1]).size();
+        return true;
+    }
+    if (command == "sort") {
+        if (!expectFields(2, 2, error)) {
+            return false;
+        }
+        if (fields[1] == "title") {
+            manager.sortByTitle();
+        } else if (fields[1] == "author") {
+            manager.sortByAuthor();
+        } else if (fields[1] == "year") {
+            manager.sortByYear();
+        } else {
+            error = "sort: unknown key '" + fields[1] + "' (expected title, author or year)";
+            return false;
+        }
+        return true;
+    }
+    if (command == "export" || command == "import") {
+        if (!expectFields(2, 2, error)) {
+            return false;
+        }
+        if (command == "export") {
+            return check(manager.exportToCSV(fields[1]), error);
+        }
+        CsvImporter::Summary import;
+        if (!check(manager.importFromCSV(fields[1], &import), error)) {
+            return false;
+        }
+        if (import.rowsRejected > 0) {
+            error = "import: " + std::to_string(import.rowsRejected) + " of " + std::to_string(import.rowsRead) +
+                    " rows rejected" + (import.errors.empty() ? std::string() : ", first at " + import.errors[0]);
+            return false;
+        }
+        return true;
+    }
+    if (command == "threads") {
+        if (!expectFields(2, 2, error) || !readInt(fields[1], number, error)) {
+            return false;
+        }
+        if (number < 1) {
+            error = "threads: count must be at least 1";
+            return false;
+        }
+        manager.setThreadCount(static_cast<unsigned>(number));
+        return true;
+    }
+    if (command == "checkpoint") {
+        return expectFields(1, 1, error) && check(manager.checkpoint(), error);
+    }
+    
+    error = "unknown command '" + command + "'";
+    return false;
+}
+
+// Run every command in script
+BatchRunner::Summary BatchRunner::run(std::istream& script) {
+    Summary summary;
+    auto start = std::chrono::steady_clock::now();
+    
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(script, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        
+        ++summary.commands;
+        std::string error;
+        bool ok = CsvFormat::splitRecord(line, fields, fieldCount);
+        if (!ok) {
+            error = "malformed quoting";
+        } else {
+            ok = execute(summary, error);
+        }
+        
+        if (!ok) {
+            ++summary.failed;
+            if (summary.errors.size() < MAX_REPORTED_ERRORS) {
+                summary.errors.push_back("line " + std::to_string(lineNumber) + ": " + error);
+            }
+        }
+    }
+    
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    summary.seconds = std::chrono::duration<double>(elapsed).count();
+    return summary;
+}
@@ -0,0 +1,59 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include "LibraryManager.h"
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+// Runs a script of library commands without prompts or screen output.
+//
+// One command per line, fields separated by commas with CSV quoting:
+//
+//     add,<title>,<author>,<year>,<isbn>[,<category>]
+//     update,<id>,<field>=<value>...   (field: title, author, year, isbn, category)
+//     delete,<id>            borrow,<id>            return,<id>
+//     search-id,<id>         search-isbn,<isbn>
+//     search-title,<text>    search-author,<text>
+//     sort,title|author|year
+//     export,<file>          import,<file>
+//     threads,<count>        checkpoint
+//
+// Blank lines and lines starting with # are skipped. An update changes only
+// the fields it names; a value containing a comma is quoted together with
+// its name ("title=Sapiens, Revised"). An import counts as failed if any of
+// its rows was rejected.
+class BatchRunner {
+public:
+    struct Summary {
+        size_t commands = 0;
+        size_t failed = 0;
+        size_t matches = 0;  // books found by search commands
+        double seconds = 0;
+        std::vector<std::string> errors;  // the first MAX_REPORTED_ERRORS failures
+    };
+    
+    static const size_t MAX_REPORTED_ERRORS = 10;
+    
+private:
+    LibraryManager& manager;
+    std::vector<std::string> fields;
+    size_t fieldCount;
+    
+    bool execute(Summary& summary, std::string& error);
+    bool check(Status status, std::string& error) const;
+    bool expectFields(size_t min, size_t max, std::string& error) const;
+    bool readInt(const std::string& text, int& value, std::string& error) const;
+    bool readUpdate(const std::string& assignment, LibraryManager::BookUpdate& update, std::string& error) const;
+    
+public:
+    // Constructor
+    explicit BatchRunner(LibraryManager& manager);
+    
+    // Run every command in script. Failed commands are counted and the
+    // rest of the script still runs.
+    Summary run(std::istream& script);
+};
+
+#endif // BATCH_RUNNER_H
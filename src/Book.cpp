@@ -1,42 +1,98 @@
 #include "Book.h"
+#include "CsvFormat.h"
+#include "TableRenderer.h"
 #include <sstream>
 #include <iomanip>
 
+namespace {
+
+// Shared by every book without an author or category, so empty rows cost no allocation
+const std::shared_ptr<const std::string>& emptyString() {
+    static const std::shared_ptr<const std::string> empty = std::make_shared<const std::string>();
+    return empty;
+}
+
+}  // namespace
+
 // Default constructor
-Book::Book() : id(0), title(""), author(""), year(0), isbn(""), category(""), isAvailable(true) {}
+Book::Book() : Book(allocator_type()) {}
+
+// Empty book whose strings will be allocated from alloc
+Book::Book(const allocator_type& alloc)
+    : id(0), title(alloc), author(emptyString()), year(0), isbn(alloc),
+      category(emptyString()), isAvailable(true) {}
 
 // Parameterized constructor
 Book::Book(int id, const std::string& title, const std::string& author, 
-           int year, const std::string& isbn, const std::string& category, bool available)
-    : id(id), title(title), author(author), year(year), isbn(isbn), category(category), isAvailable(available) {}
+           int year, const std::string& isbn, const std::string& category, bool available,
+           const allocator_type& alloc)
+    : id(id), title(title, alloc), author(std::make_shared<const std::string>(author)), year(year),
+      isbn(isbn, alloc), category(std::make_shared<const std::string>(category)), isAvailable(available) {}
+
+// Copy other, allocating its strings from alloc
+Book::Book(const Book& other, const allocator_type& alloc)
+    : id(other.id), title(other.title, alloc), author(other.author), year(other.year),
+      isbn(other.isbn, alloc), category(other.category), isAvailable(other.getAvailability()) {}
+
+// Move other; its strings are only copied if alloc uses a different resource
+Book::Book(Book&& other, const allocator_type& alloc)
+    : id(other.id), title(std::move(other.title), alloc), author(std::move(other.author)), year(other.year),
+      isbn(std::move(other.isbn), alloc), category(std::move(other.category)), isAvailable(other.getAvailability()) {}
+
+// Copy constructor
+Book::Book(const Book& other)
+    : id(other.id), title(other.title), author(other.author), year(other.year), isbn(other.isbn),
+      category(other.category), isAvailable(other.getAvailability()) {}
+
+// Move constructor
+Book::Book(Book&& other) noexcept
+    : id(other.id), title(std::move(other.title)), author(std::move(other.author)), year(other.year),
+      isbn(std::move(other.isbn)), category(std::move(other.category)), isAvailable(other.getAvailability()) {}
+
+// Copy assignment; strings stay with this book's allocator
+Book& Book::operator=(const Book& other) {
+    id = other.id;
+    title = other.title;
+    author = other.author;
+    year = other.year;
+    isbn = other.isbn;
+    category = other.category;
+    setAvailability(other.getAvailability());
+    return *this;
+}
+
+// Move assignment
+Book& Book::operator=(Book&& other) {
+    id = other.id;
+    title = std::move(other.title);
+    author = std::move(other.author);
+    year = other.year;
+    isbn = std::move(other.isbn);
+    category = std::move(other.category);
+    setAvailability(other.getAvailability());
+    return *this;
+}
 
 // Display book information
 void Book::displayBook() const {
-    std::cout << std::left << std::setw(5) << id 
-              << std::setw(25) << title 
-              << std::setw(20) << author 
-              << std::setw(6) << year 
-              << std::setw(15) << isbn 
-              << std::setw(15) << category 
-              << std::setw(10) << (isAvailable ? "Available" : "Borrowed") 
-              << std::endl;
+    TableRenderer table(std::cout);
+    table.addRow(*this);
 }
 
 // Convert book to string representation
 std::string Book::toString() const {
     std::ostringstream oss;
-    oss << "ID: " << id << ", Title: " << title << ", Author: " << author 
-        << ", Year: " << year << ", ISBN: " << isbn << ", Category: " << category 
-        << ", Status: " << (isAvailable ? "Available" : "Borrowed");
+    oss << "ID: " << id << ", Title: " << title << ", Author: " << *author 
+        << ", Year: " << year << ", ISBN: " << isbn << ", Category: " << *category 
+        << ", Status: " << (getAvailability() ? "Available" : "Borrowed");
     return oss.str();
 }
 
 // Convert book to CSV format
 std::string Book::toCSV() const {
-    std::ostringstream oss;
-    oss << id << "," << title << "," << author << "," << year << "," 
-        << isbn << "," << category << "," << (isAvailable ? "Available" : "Borrowed");
-    return oss.str();
+    std::string line;
+    CsvFormat::appendBook(line, *this);
+    return line;
 }
 
 // Write book data to binary file
@@ -47,9 +103,9 @@ void Book::writeToFile(std::ofstream& out) const {
     out.write(reinterpret_cast<const char*>(&titleSize), sizeof(titleSize));
     out.write(title.c_str(), titleSize);
     
-    size_t authorSize = author.size();
+    size_t authorSize = author->size();
     out.write(reinterpret_cast<const char*>(&authorSize), sizeof(authorSize));
-    out.write(author.c_str(), authorSize);
+    out.write(author->c_str(), authorSize);
     
     out.write(reinterpret_cast<const char*>(&year), sizeof(year));
     
@@ -57,11 +113,12 @@ void Book::writeToFile(std::ofstream& out) const {
     out.write(reinterpret_cast<const char*>(&isbnSize), sizeof(isbnSize));
     out.write(isbn.c_str(), isbnSize);
     
-    size_t categorySize = category.size();
+    size_t categorySize = category->size();
     out.write(reinterpret_cast<const char*>(&categorySize), sizeof(categorySize));
-    out.write(category.c_str(), categorySize);
+    out.write(category->c_str(), categorySize);
     
-    out.write(reinterpret_cast<const char*>(&isAvailable), sizeof(isAvailable));
+    bool available = getAvailability();
+    out.write(reinterpret_cast<const char*>(&available), sizeof(available));
 }
 
 // Read book data from binary file
@@ -75,8 +132,9 @@ void Book::readFromFile(std::ifstream& in) {
     
     size_t authorSize;
     in.read(reinterpret_cast<char*>(&authorSize), sizeof(authorSize));
-    author.resize(authorSize);
-    in.read(&author[0], authorSize);
+    std::string authorValue(authorSize, '\0');
+    in.read(&authorValue[0], authorSize);
+    setAuthor(authorValue);
     
     in.read(reinterpret_cast<char*>(&year), sizeof(year));
     
@@ -87,10 +145,13 @@ void Book::readFromFile(std::ifstream& in) {
     
     size_t categorySize;
     in.read(reinterpret_cast<char*>(&categorySize), sizeof(categorySize));
-    category.resize(categorySize);
-    in.read(&category[0], categorySize);
+    std::string categoryValue(categorySize, '\0');
+    in.read(&categoryValue[0], categorySize);
+    setCategory(categoryValue);
     
-    in.read(reinterpret_cast<char*>(&isAvailable), sizeof(isAvailable));
+    bool available = true;
+    in.read(reinterpret_cast<char*>(&available), sizeof(available));
+    setAvailability(available);
 }
 
 // Equality operator
@@ -1,43 +1,64 @@
 #ifndef BOOK_H
 #define BOOK_H
 
+#include <atomic>
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
 
 class Book {
+public:
+    // Title and ISBN are allocated from this allocator's memory resource,
+    // which lets a catalog keep them in one arena
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+    
 private:
     int id;
-    std::string title;
-    std::string author;
+    std::pmr::string title;
+    std::shared_ptr<const std::string> author;    // shared with other books by the same author
     int year;
-    std::string isbn;
-    std::string category;
-    bool isAvailable;
+    std::pmr::string isbn;
+    std::shared_ptr<const std::string> category;  // shared with other books in the category
+    std::atomic<bool> isAvailable;  // changed by borrow and return while others read the book
 
 public:
     // Constructors
     Book();
+    explicit Book(const allocator_type& alloc);
     Book(int id, const std::string& title, const std::string& author, 
-         int year, const std::string& isbn, const std::string& category, bool available = true);
+         int year, const std::string& isbn, const std::string& category, bool available = true,
+         const allocator_type& alloc = allocator_type());
+    Book(const Book& other, const allocator_type& alloc);
+    Book(Book&& other, const allocator_type& alloc);
+    Book(const Book& other);
+    Book(Book&& other) noexcept;
+    Book& operator=(const Book& other);
+    Book& operator=(Book&& other);
     
     // Getters
     int getId() const { return id; }
-    std::string getTitle() const { return title; }
-    std::string getAuthor() const { return author; }
+    const std::pmr::string& getTitle() const { return title; }
+    const std::string& getAuthor() const { return *author; }
     int getYear() const { return year; }
-    std::string getIsbn() const { return isbn; }
-    std::string getCategory() const { return category; }
-    bool getAvailability() const { return isAvailable; }
+    const std::pmr::string& getIsbn() const { return isbn; }
+    const std::string& getCategory() const { return *category; }
+    bool getAvailability() const { return isAvailable.load(std::memory_order_relaxed); }
     
     // Setters
     void setId(int newId) { id = newId; }
-    void setTitle(const std::string& newTitle) { title = newTitle; }
-    void setAuthor(const std::string& newAuthor) { author = newAuthor; }
+    void setTitle(std::string_view newTitle) { title.assign(newTitle.data(), newTitle.size()); }
+    void setAuthor(const std::string& newAuthor) { author = std::make_shared<const std::string>(newAuthor); }
     void setYear(int newYear) { year = newYear; }
-    void setIsbn(const std::string& newIsbn) { isbn = newIsbn; }
-    void setCategory(const std::string& newCategory) { category = newCategory; }
-    void setAvailability(bool available) { isAvailable = available; }
+    void setIsbn(std::string_view newIsbn) { isbn.assign(newIsbn.data(), newIsbn.size()); }
+    void setCategory(const std::string& newCategory) { category = std::make_shared<const std::string>(newCategory); }
+    void setAvailability(bool available) { isAvailable.store(available, std::memory_order_relaxed); }
+    
+    // Share an interned value instead of holding a private copy
+    void shareAuthor(std::shared_ptr<const std::string> sharedAuthor) { author = std::move(sharedAuthor); }
+    void shareCategory(std::shared_ptr<const std::string> sharedCategory) { category = std::move(sharedCategory); }
     
     // Utility methods
     void displayBook() const;
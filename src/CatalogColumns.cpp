@@ -0,0 +1,82 @@
+#include "CatalogColumns.h"
+
+namespace {
+
+template <typename T>
+void permuteColumn(std::vector<T>& column, const std::vector<size_t>& order) {
+    std::vector<T> reordered;
+    reordered.reserve(order.size());
+    for (size_t slot : order) {
+        reordered.push_back(column[slot]);
+    }
+    column.swap(reordered);
+}
+
+}  // namespace
+
+// Constructor
+CatalogColumns::CatalogColumns() : deletedRows(0) {}
+
+// Remove all entries
+void CatalogColumns::clear() {
+    ids.clear();
+    years.clear();
+    available.clear();
+    authorIds.clear();
+    categoryIds.clear();
+    deleted.clear();
+    deletedRows = 0;
+}
+
+// Reserve room for count entries in every column
+void CatalogColumns::reserve(size_t count) {
+    ids.reserve(count);
+    years.reserve(count);
+    available.reserve(count);
+    authorIds.reserve(count);
+    categoryIds.reserve(count);
+    deleted.reserve(count);
+}
+
+// Add an entry for a new last slot
+void CatalogColumns::append(int id, int year, bool isAvailable, uint32_t authorId, uint32_t categoryId) {
+    ids.push_back(id);
+    years.push_back(year);
+    available.append(isAvailable);
+    authorIds.push_back(authorId);
+    categoryIds.push_back(categoryId);
+    deleted.push_back(0);
+}
+
+// Remove the entry for slot, shifting later slots down
+void CatalogColumns::erase(size_t slot) {
+    ids.erase(ids.begin() + slot);
+    years.erase(years.begin() + slot);
+    available.erase(slot);
+    authorIds.erase(authorIds.begin() + slot);
+    categoryIds.erase(categoryIds.begin() + slot);
+    deletedRows -= deleted[slot];
+    deleted.erase(deleted.begin() + slot);
+}
+
+// Apply a slot permutation to every column
+void CatalogColumns::permute(const std::vector<size_t>& order) {
+    permuteColumn(ids, order);
+    permuteColumn(years, order);
+    available.permute(order);
+    permuteColumn(authorIds, order);
+    permuteColumn(categoryIds, order);
+    permuteColumn(deleted, order);
+    deletedRows = 0;
+    for (uint8_t flag : deleted) {
+        deletedRows += flag;
+    }
+}
+
+// Mark slot deleted, leaving every other slot where it is
+void CatalogColumns::markDeleted(size_t slot) {
+    if (!deleted[slot]) {
+        deleted[slot] = 1;
+        ++deletedRows;
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef CATALOG_COLUMNS_H
+#define CATALOG_COLUMNS_H
+
+#include "AvailabilityBitmap.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Fixed-width book fields stored column by column, one entry per catalog
+// slot. Counting, filtering and sorting on these fields walk dense arrays
+// instead of whole Book records. Authors and categories are stored as
+// StringPool IDs, so equality filters and group-bys compare integers.
+// Availability is an AvailabilityBitmap, which may be changed and counted
+// concurrently; the other columns need outside locking.
+//
+// A slot can be marked deleted instead of erased, so that removing a row
+// does not shift every later one; permute with the remaining slots drops
+// the marked ones in one pass.
+class CatalogColumns {
+private:
+    std::vector<int> ids;
+    std::vector<int> years;
+    AvailabilityBitmap available;
+    std::vector<uint32_t> authorIds;
+    std::vector<uint32_t> categoryIds;
+    std::vector<uint8_t> deleted;
+    size_t deletedRows;
+    
+public:
+    // Constructor
+    CatalogColumns();
+    
+    size_t size() const { return ids.size(); }
+    void clear();
+    void reserve(size_t count);
+    
+    void append(int id, int year, bool isAvailable, uint32_t authorId, uint32_t categoryId);
+    void erase(size_t slot);
+    // Reorder so that new slot i holds what was in slot order[i]; slots
+    // missing from order are dropped
+    void permute(const std::vector<size_t>& order);
+    
+    void markDeleted(size_t slot);
+    bool isDeleted(size_t slot) const { return deleted[slot] != 0; }
+    size_t deletedCount() const { return deletedRows; }
+    
+    int yearAt(size_t slot) const { return years[slot]; }
+    bool availableAt(size_t slot) const { return available.test(slot); }
+    uint32_t authorIdAt(size_t slot) const { return authorIds[slot]; }
+    uint32_t categoryIdAt(size_t slot) const { return categoryIds[slot]; }
+    void setYear(size_t slot, int year) { years[slot] = year; }
+    void setAvailable(size_t slot, bool isAvailable) { available.set(slot, isAvailable); }
+    // Borrow or return slot atomically; see AvailabilityBitmap::claim
+    bool claimAvailable(size_t slot, bool isAvailable) { return available.claim(slot, isAvailable); }
+    void releaseAvailable(size_t slot) { available.release(slot); }
+    void revertAvailable(size_t slot) { available.revert(slot); }
+    void setAuthorId(size_t slot, uint32_t authorId) { authorIds[slot] = authorId; }
+    void setCategoryId(size_t slot, uint32_t categoryId) { categoryIds[slot] = categoryId; }
+    
+    const std::vector<uint32_t>& authorIdColumn() const { return authorIds; }
+    const std::vector<uint32_t>& categoryIdColumn() const { return categoryIds; }
+};
+
+#endif // CATALOG_COLUMNS_H
@@ -0,0 +1,387 @@
+#include "CatalogFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char MAGIC[8] = {'L', 'I', 'B', 'C', 'A', 'T', '\0', '\0'};
+const uint32_t OLDEST_READABLE_VERSION = 2;
+const size_t MAX_RECORD_FIELDS = 4;
+
+// Version 2 entries stop before the dictionary IDs
+const size_t V2_ENTRY_SIZE = offsetof(CatalogFile::IndexEntry, authorId);
+
+// Length-prefixed string reader over the mapping
+bool readString(const char* data, size_t size, uint64_t& offset, std::string_view& value) {
+    uint32_t length;
+    if (offset > size || size - offset < sizeof(length)) {
+        return false;
+    }
+    std::memcpy(&length, data + offset, sizeof(length));
+    offset += sizeof(length);
+    if (size - offset < length) {
+        return false;
+    }
+    value = std::string_view(data + offset, length);
+    offset += length;
+    return true;
+}
+
+void writeString(std::ofstream& out, std::string_view value) {
+    uint32_t length = static_cast<uint32_t>(value.size());
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.write(value.data(), value.size());
+}
+
+// Assigns dictionary IDs in first-seen order
+class DictionaryBuilder {
+private:
+    std::unordered_map<std::string_view, uint32_t> ids;
+    
+public:
+    std::vector<std::string_view> values;
+    
+    uint32_t idOf(std::string_view value) {
+        auto it = ids.emplace(value, static_cast<uint32_t>(values.size()));
+        if (it.second) {
+            values.push_back(value);
+        }
+        return it.first->second;
+    }
+    
+    uint64_t encodedSize() const {
+        uint64_t total = 0;
+        for (std::string_view value : values) {
+            total += sizeof(uint32_t) + value.size();
+        }
+        return total;
+    }
+};
+
+bool readLegacyBooks(const std::string& filename, std::vector<Book>& books, int& nextId) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    while (in.peek() != EOF) {
+        Book book;
+        book.readFromFile(in);
+        if (!in.good()) {
+            return false;
+        }
+        nextId = std::max(nextId, book.getId() + 1);
+        books.push_back(book);
+    }
+    return true;
+}
+
+}  // namespace
+
+// Constructor
+CatalogFile::CatalogFile() : data(nullptr), size(0), header(), entrySize(0) {}
+
+// Destructor
+CatalogFile::~CatalogFile() {
+    close();
+}
+
+// Map filename and validate its header, index and dictionaries
+bool CatalogFile::open(const std::string& filename) {
+    close();
+    
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    
+    struct stat info;
+    const size_t minimumHeader = offsetof(Header, dictionaryOffset);
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < minimumHeader) {
+        ::close(fd);
+        return false;
+    }
+    
+    size_t length = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    
+    data = static_cast<const char*>(mapping);
+    size = length;
+    std::memcpy(&header, data, minimumHeader);
+    
+    bool valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                 header.version >= OLDEST_READABLE_VERSION && header.version <= FORMAT_VERSION;
+    if (valid && header.version >= 3) {
+        valid = length >= sizeof(Header);
+        if (valid) {
+            std::memcpy(&header, data, sizeof(Header));
+        }
+    }
+    entrySize = header.version >= 3 ? sizeof(IndexEntry) : V2_ENTRY_SIZE;
+    valid = valid && header.indexOffset >= minimumHeader && header.indexOffset <= length &&
+            header.recordCount <= (length - header.indexOffset) / entrySize &&
+            readDictionaries();
+    
+    if (!valid) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Load the dictionary string views (version 3 and later)
+bool CatalogFile::readDictionaries() {
+    authorDictionary.clear();
+    categoryDictionary.clear();
+    if (header.version < 3) {
+        return true;
+    }
+    
+    uint64_t offset = header.dictionaryOffset;
+    std::string_view value;
+    authorDictionary.reserve(std::min<size_t>(header.authorCount, size / sizeof(uint32_t)));
+    for (uint32_t i = 0; i < header.authorCount; ++i) {
+        if (!readString(data, size, offset, value)) {
+            return false;
+        }
+        authorDictionary.push_back(value);
+    }
+    categoryDictionary.reserve(std::min<size_t>(header.categoryCount, size / sizeof(uint32_t)));
+    for (uint32_t i = 0; i < header.categoryCount; ++i) {
+        if (!readString(data, size, offset, value)) {
+            return false;
+        }
+        categoryDictionary.push_back(value);
+    }
+    return true;
+}
+
+// Unmap the file
+void CatalogFile::close() {
+    if (data) {
+        munmap(const_cast<char*>(data), size);
+    }
+    data = nullptr;
+    size = 0;
+    header = Header();
+    entrySize = 0;
+    authorDictionary.clear();
+    categoryDictionary.clear();
+}
+
+// Number of records in the mapped file
+size_t CatalogFile::recordCount() const {
+    return data ? static_cast<size_t>(header.recordCount) : 0;
+}
+
+// Next ID to hand out, as saved with the file
+int CatalogFile::nextId() const {
+    return data ? header.nextId : 1;
+}
+
+// Fixed-width fields of one record
+CatalogFile::IndexEntry CatalogFile::entry(size_t record) const {
+    IndexEntry result;
+    result.authorId = NO_DICTIONARY_ID;
+    result.categoryId = NO_DICTIONARY_ID;
+    std::memcpy(&result, data + header.indexOffset + record * entrySize, entrySize);
+    return result;
+}
+
+// Read the count strings stored with a record: their lengths, then their bytes
+bool CatalogFile::readFields(size_t record, std::string_view* fields, size_t count) const {
+    uint64_t offset = entry(record).recordOffset;
+    uint32_t lengths[MAX_RECORD_FIELDS];
+    if (offset > size || size - offset < count * sizeof(uint32_t)) {
+        return false;
+    }
+    std::memcpy(lengths, data + offset, count * sizeof(uint32_t));
+    
+    const char* cursor = data + offset + count * sizeof(uint32_t);
+    size_t remaining = size - offset - count * sizeof(uint32_t);
+    for (size_t i = 0; i < count; ++i) {
+        if (lengths[i] > remaining) {
+            return false;
+        }
+        fields[i] = std::string_view(cursor, lengths[i]);
+        cursor += lengths[i];
+        remaining -= lengths[i];
+    }
+    return true;
+}
+
+// Decode the strings stored with one record into book
+bool CatalogFile::readStrings(size_t record, Book& book) const {
+    if (header.version < 3) {
+        std::string_view fields[4];
+        if (!readFields(record, fields, 4)) {
+            return false;
+        }
+        book.setTitle(fields[0]);
+        book.setAuthor(std::string(fields[1]));
+        book.setIsbn(fields[2]);
+        book.setCategory(std::string(fields[3]));
+        return true;
+    }
+    
+    std::string_view fields[2];
+    if (!readFields(record, fields, 2)) {
+        return false;
+    }
+    book.setTitle(fields[0]);
+    book.setIsbn(fields[1]);
+    return true;
+}
+
+// Decode a whole record
+bool CatalogFile::readBook(size_t record, Book& book) const {
+    IndexEntry fixed = entry(record);
+    book.setId(fixed.id);
+    book.setYear(fixed.year);
+    book.setAvailability(fixed.available != 0);
+    if (header.version >= 3) {
+        if (fixed.authorId >= authorDictionary.size() || fixed.categoryId >= categoryDictionary.size()) {
+            return false;
+        }
+        book.setAuthor(std::string(authorDictionary[fixed.authorId]));
+        book.setCategory(std::string(categoryDictionary[fixed.categoryId]));
+    }
+    return readStrings(record, book);
+}
+
+// Write books to filename in the current format
+bool CatalogFile::write(const std::string& filename, const std::vector<Book>& books, int nextId) {
+    DictionaryBuilder authors;
+    DictionaryBuilder categories;
+    std::vector<IndexEntry> index(books.size());
+    for (size_t i = 0; i < books.size(); ++i) {
+        index[i] = IndexEntry();
+        index[i].id = books[i].getId();
+        index[i].year = static_cast<int16_t>(books[i].getYear());
+        index[i].available = books[i].getAvailability() ? 1 : 0;
+        index[i].authorId = authors.idOf(books[i].getAuthor());
+        index[i].categoryId = categories.idOf(books[i].getCategory());
+    }
+    
+    Header fileHeader = {};
+    std::memcpy(fileHeader.magic, MAGIC, sizeof(MAGIC));
+    fileHeader.version = FORMAT_VERSION;
+    fileHeader.recordCount = books.size();
+    fileHeader.indexOffset = sizeof(Header);
+    fileHeader.nextId = nextId;
+    fileHeader.dictionaryOffset = sizeof(Header) + books.size() * sizeof(IndexEntry);
+    fileHeader.authorCount = static_cast<uint32_t>(authors.values.size());
+    fileHeader.categoryCount = static_cast<uint32_t>(categories.values.size());
+    
+    uint64_t offset = fileHeader.dictionaryOffset + authors.encodedSize() + categories.encodedSize();
+    for (size_t i = 0; i < books.size(); ++i) {
+        index[i].recordOffset = offset;
+        offset += 2 * sizeof(uint32_t) + books[i].getTitle().size() + books[i].getIsbn().size();
+    }
+    
+    std::string tempFile = filename + ".tmp";
+    std::ofstream out(tempFile, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    
+    out.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+    out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(IndexEntry));
+    for (std::string_view author : authors.values) {
+        writeString(out, author);
+    }
+    for (std::string_view category : categories.values) {
+        writeString(out, category);
+    }
+    for (const auto& book : books) {
+        uint32_t lengths[2] = {static_cast<uint32_t>(book.getTitle().size()),
+                               static_cast<uint32_t>(book.getIsbn().size())};
+        out.write(reinterpret_cast<const char*>(lengths), sizeof(lengths));
+        out.write(book.getTitle().data(), book.getTitle().size());
+        out.write(book.getIsbn().data(), book.getIsbn().size());
+    }
+    
+    out.close();
+    if (!out) {
+        std::remove(tempFile.c_str());
+        return false;
+    }
+    
+    // Make the new contents durable before the rename makes them visible
+    int fd = ::open(tempFile.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        ::close(fd);
+    }
+    return std::rename(tempFile.c_str(), filename.c_str()) == 0;
+}
+
+// Check for a legacy or older-version data file
+bool CatalogFile::needsMigration(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open() || in.peek() == EOF) {
+        return false;
+    }
+    char magic[sizeof(MAGIC)] = {};
+    uint32_t fileVersion = 0;
+    in.read(magic, sizeof(magic));
+    if (in.gcount() != sizeof(magic) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        return true;
+    }
+    in.read(reinterpret_cast<char*>(&fileVersion), sizeof(fileVersion));
+    return in.gcount() == sizeof(fileVersion) && fileVersion < FORMAT_VERSION;
+}
+
+// Convert a legacy or older-version data file to the current format
+long CatalogFile::migrate(const std::string& filename) {
+    std::vector<Book> books;
+    int nextId = 1;
+    
+    CatalogFile old;
+    if (old.open(filename)) {
+        books.resize(old.recordCount());
+        for (size_t record = 0; record < books.size(); ++record) {
+            if (!old.readBook(record, books[record])) {
+                return -1;
+            }
+        }
+        nextId = old.nextId();
+        old.close();
+    } else if (!readLegacyBooks(filename, books, nextId)) {
+        return -1;
+    }
+    
+    if (!write(filename, books, nextId)) {
+        return -1;
+    }
+    return static_cast<long>(books.size());
+}
+
+// Check for a missing or empty data file
+bool CatalogFile::isMissingOrEmpty(const std::string& filename) {
+    struct stat info;
+    if (::stat(filename.c_str(), &info) != 0) {
+        return errno == ENOENT;
+    }
+    return S_ISREG(info.st_mode) && info.st_size == 0;
+}
+
+// Check for a legacy data file
+bool CatalogFile::isLegacy(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    char magic[sizeof(MAGIC)] = {};
+    in.read(magic, sizeof(magic));
+    return in.gcount() > 0 && (in.gcount() != sizeof(magic) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0);
+}
@@ -0,0 +1,114 @@
+#ifndef CATALOG_FILE_H
+#define CATALOG_FILE_H
+
+#include "Book.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Versioned, memory-mapped catalog data file.
+//
+// Layout (native byte order, version 3):
+//   Header      magic, version, record count, next ID, offsets of the index
+//               and the dictionaries
+//   Index       one fixed-width IndexEntry per record (ID, year, availability,
+//               author and category dictionary IDs, offset of the record's
+//               strings)
+//   Dictionary  the distinct authors, then the distinct categories, each a
+//               length-prefixed string; an entry's dictionary ID is its position
+//   Records     per book, the lengths of its title and ISBN followed by
+//               their bytes
+//
+// Version 2 files (no dictionaries; title, author, ISBN and category all
+// stored per record) can still be opened so that migrate() can upgrade them.
+//
+// The file is mapped read-only, so opening it costs the same for any catalog
+// size; fixed-width fields come straight from the index and the strings of a
+// record are only decoded when it is read.
+class CatalogFile {
+public:
+    static const uint32_t FORMAT_VERSION = 3;
+    static const uint32_t NO_DICTIONARY_ID = UINT32_MAX;
+    
+    struct IndexEntry {
+        uint64_t recordOffset;
+        int32_t id;
+        int16_t year;
+        uint8_t available;
+        uint8_t reserved;
+        uint32_t authorId;
+        uint32_t categoryId;
+    };
+    
+private:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t recordCount;
+        uint64_t indexOffset;
+        int32_t nextId;
+        uint32_t padding;
+        // Version 3 and later
+        uint64_t dictionaryOffset;
+        uint32_t authorCount;
+        uint32_t categoryCount;
+    };
+    
+    const char* data;
+    size_t size;
+    Header header;
+    size_t entrySize;
+    std::vector<std::string_view> authorDictionary;
+    std::vector<std::string_view> categoryDictionary;
+    
+    bool readDictionaries();
+    bool readFields(size_t record, std::string_view* fields, size_t count) const;
+    
+public:
+    // Constructors
+    CatalogFile();
+    CatalogFile(const CatalogFile&) = delete;
+    CatalogFile& operator=(const CatalogFile&) = delete;
+    
+    // Destructor
+    ~CatalogFile();
+    
+    // Map an existing file; false if it is missing or not in a supported format
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+    
+    // Mapped contents
+    uint32_t version() const { return header.version; }
+    size_t recordCount() const;
+    int nextId() const;
+    IndexEntry entry(size_t record) const;
+    const std::vector<std::string_view>& authors() const { return authorDictionary; }
+    const std::vector<std::string_view>& categories() const { return categoryDictionary; }
+    
+    // Decode the strings stored with a record: title and ISBN (plus author
+    // and category for version 2 files)
+    bool readStrings(size_t record, Book& book) const;
+    // Decode a whole record, resolving dictionary IDs
+    bool readBook(size_t record, Book& book) const;
+    
+    // Write books in the current format to filename (via a temporary file and rename)
+    static bool write(const std::string& filename, const std::vector<Book>& books, int nextId);
+    
+    // True if filename exists but is a legacy file (raw Book::writeToFile
+    // records) or an older version of this format
+    static bool needsMigration(const std::string& filename);
+    // Rewrite such a file in the current format; returns the number of books
+    // migrated, or -1 (leaving the file as it was) if any record is unreadable
+    static long migrate(const std::string& filename);
+    // True if there is no file at filename, or an empty one: nothing a new
+    // catalog would write over (as opposed to a file that cannot be read)
+    static bool isMissingOrEmpty(const std::string& filename);
+    // True if filename holds legacy records: it is not empty and does not
+    // start with this format's magic
+    static bool isLegacy(const std::string& filename);
+};
+
+#endif // CATALOG_FILE_H
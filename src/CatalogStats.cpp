@@ -0,0 +1,73 @@
+#include "CatalogStats.h"
+#include "StringPool.h"
+
+// Constructor
+CatalogStats::CatalogStats() : total(0), available(0) {}
+
+// Forget every book
+void CatalogStats::clear() {
+    total = 0;
+    available.store(0, std::memory_order_relaxed);
+    authorCounts.clear();
+    categoryCounts.clear();
+    decadeCounts.clear();
+}
+
+// Add one to (or take one from) the count for a dictionary ID
+void CatalogStats::adjust(std::vector<size_t>& counts, uint32_t id, bool add) {
+    if (id == StringPool::NOT_FOUND) {
+        return;
+    }
+    if (id >= counts.size()) {
+        counts.resize(id + 1, 0);
+    }
+    if (add) {
+        ++counts[id];
+    } else {
+        --counts[id];
+    }
+}
+
+// Add one to (or take one from) the decade of year, dropping empty decades
+void CatalogStats::adjustDecade(int year, bool add) {
+    int decade = decadeOf(year);
+    if (add) {
+        ++decadeCounts[decade];
+        return;
+    }
+    auto it = decadeCounts.find(decade);
+    if (it != decadeCounts.end() && --it->second == 0) {
+        decadeCounts.erase(it);
+    }
+}
+
+// Count a book added to the catalog
+void CatalogStats::add(int year, bool isAvailable, uint32_t authorId, uint32_t categoryId) {
+    ++total;
+    if (isAvailable) {
+        available.fetch_add(1, std::memory_order_relaxed);
+    }
+    adjust(authorCounts, authorId, true);
+    adjust(categoryCounts, categoryId, true);
+    adjustDecade(year, true);
+}
+
+// Uncount a book leaving the catalog, with the values it was counted with
+void CatalogStats::remove(int year, bool isAvailable, uint32_t authorId, uint32_t categoryId) {
+    --total;
+    if (isAvailable) {
+        available.fetch_sub(1, std::memory_order_relaxed);
+    }
+    adjust(authorCounts, authorId, false);
+    adjust(categoryCounts, categoryId, false);
+    adjustDecade(year, false);
+}
+
+// A book was returned (isAvailable) or borrowed
+void CatalogStats::changeAvailable(bool isAvailable) {
+    if (isAvailable) {
+        available.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        available.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef CATALOG_STATS_H
+#define CATALOG_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// Running totals over the catalog: books, available books, and books per
+// author, category (by StringPool ID) and publication decade. Every
+// mutation adjusts them as it happens, so statistics are read without
+// scanning the catalog.
+//
+// The available count may be changed and read from any thread, to follow
+// borrows and returns made under the shared lock; the other counters need
+// outside locking.
+class CatalogStats {
+private:
+    size_t total;
+    std::atomic<size_t> available;
+    std::vector<size_t> authorCounts;    // indexed by author ID
+    std::vector<size_t> categoryCounts;  // indexed by category ID
+    std::map<int, size_t> decadeCounts;  // first year of decade -> books
+
+    static void adjust(std::vector<size_t>& counts, uint32_t id, bool add);
+    void adjustDecade(int year, bool add);
+
+public:
+    // Constructor
+    CatalogStats();
+
+    void clear();
+    // Count a book entering or leaving the catalog
+    void add(int year, bool isAvailable, uint32_t authorId, uint32_t categoryId);
+    void remove(int year, bool isAvailable, uint32_t authorId, uint32_t categoryId);
+    // Follow a book becoming available (or borrowed)
+    void changeAvailable(bool isAvailable);
+
+    size_t totalCount() const { return total; }
+    size_t availableCount() const { return available.load(std::memory_order_relaxed); }
+    const std::vector<size_t>& authorCountColumn() const { return authorCounts; }
+    const std::vector<size_t>& categoryCountColumn() const { return categoryCounts; }
+    const std::map<int, size_t>& decadeCountMap() const { return decadeCounts; }
+
+    static int decadeOf(int year) { return year - ((year % 10) + 10) % 10; }
+};
+
+#endif // CATALOG_STATS_H
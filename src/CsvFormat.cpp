@@ -0,0 +1,96 @@
+#include "CsvFormat.h"
+#include "Book.h"
+#include <algorithm>
+#include <charconv>
+
+const char* const CsvFormat::HEADER = "ID,Title,Author,Year,ISBN,Category,Status";
+
+// Append field, quoted if it contains a comma, quote or line break
+void CsvFormat::appendField(std::string& out, std::string_view field) {
+    if (field.find_first_of(",\"\r\n") == std::string_view::npos) {
+        out.append(field.data(), field.size());
+        return;
+    }
+    
+    out += '"';
+    size_t start = 0;
+    size_t quote;
+    while ((quote = field.find('"', start)) != std::string_view::npos) {
+        out.append(field.data() + start, quote + 1 - start);
+        out += '"';
+        start = quote + 1;
+    }
+    out.append(field.data() + start, field.size() - start);
+    out += '"';
+}
+
+// Append value in decimal
+void CsvFormat::appendInt(std::string& out, int value) {
+    char digits[16];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+// Append one record for book, without the line ending
+void CsvFormat::appendBook(std::string& out, const Book& book) {
+    appendInt(out, book.getId());
+    out += ',';
+    appendField(out, book.getTitle());
+    out += ',';
+    appendField(out, book.getAuthor());
+    out += ',';
+    appendInt(out, book.getYear());
+    out += ',';
+    appendField(out, book.getIsbn());
+    out += ',';
+    appendField(out, book.getCategory());
+    out += ',';
+    out += book.getAvailability() ? "Available" : "Borrowed";
+}
+
+// Split one record into fields, undoing quoting
+bool CsvFormat::splitRecord(std::string_view record, std::vector<std::string>& fields, size_t& count) {
+    count = 0;
+    size_t pos = 0;
+    while (true) {
+        if (count == fields.size()) {
+            fields.emplace_back();
+        }
+        std::string& field = fields[count++];
+        field.clear();
+
+        if (pos < record.size() && record[pos] == '"') {
+            ++pos;
+            while (true) {
+                if (pos >= record.size()) {
+                    return false;  // unterminated quoted field
+                }
+                char c = record[pos++];
+                if (c != '"') {
+                    field += c;
+                } else if (pos < record.size() && record[pos] == '"') {
+                    field += '"';
+                    ++pos;
+                } else {
+                    break;
+                }
+            }
+            if (pos < record.size() && record[pos] != ',') {
+                return false;  // text after the closing quote
+            }
+        } else {
+            size_t end = std::min(record.find(',', pos), record.size());
+            std::string_view value = record.substr(pos, end - pos);
+            if (value.find('"') != std::string_view::npos) {
+                return false;  // quotes are only allowed in quoted fields
+            }
+            field.assign(value.data(), value.size());
+            pos = end;
+        }
+
+        if (pos >= record.size()) {
+            return true;
+        }
+        ++pos;  // the comma
+    }
+}
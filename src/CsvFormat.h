@@ -0,0 +1,33 @@
+#ifndef CSV_FORMAT_H
+#define CSV_FORMAT_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Book;
+
+// RFC 4180 helpers. The formatting functions append to a caller-owned
+// buffer, so a whole block of rows can be built without temporary strings
+// or streams.
+namespace CsvFormat {
+    // Header line written by exportToCSV, without the line ending
+    extern const char* const HEADER;
+    
+    // Append field, quoted if it contains a comma, quote or line break
+    void appendField(std::string& out, std::string_view field);
+    
+    // Append value in decimal
+    void appendInt(std::string& out, int value);
+    
+    // Append one record for book, without the line ending
+    void appendBook(std::string& out, const Book& book);
+    
+    // Split one record (without its line ending) into fields, undoing
+    // quoting. count is the number of fields; entries of fields beyond it
+    // are stale and kept only for their capacity. False if the quoting is
+    // malformed.
+    bool splitRecord(std::string_view record, std::vector<std::string>& fields, size_t& count);
+}
+
+#endif // CSV_FORMAT_H
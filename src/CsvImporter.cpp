@@ -0,0 +1,255 @@
+#include "CsvImporter.h"
+#include "CsvFormat.h"
+#include "ISBN.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+
+namespace {
+
+// Records per thread below which a chunk is parsed on the calling thread
+const size_t MIN_RECORDS_PER_THREAD = 1024;
+
+// ASCII case-insensitive equality
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+// A record without its line ending
+std::string_view trimLineEnding(std::string_view record) {
+    if (!record.empty() && record.back() == '\n') {
+        record.remove_suffix(1);
+    }
+    if (!record.empty() && record.back() == '\r') {
+        record.remove_suffix(1);
+    }
+    return record;
+}
+
+}  // namespace
+
+// Constructor
+CsvImporter::CsvImporter(ThreadPool* pool, size_t chunkBytes)
+    : pool(pool), chunkBytes(std::max<size_t>(chunkBytes, 1)) {}
+
+// Map header names to column positions
+bool CsvImporter::readHeader(std::string_view record, std::string& error) {
+    std::vector<std::string> names;
+    size_t count = 0;
+    if (!CsvFormat::splitRecord(trimLineEnding(record), names, count)) {
+        error = "malformed header";
+        return false;
+    }
+
+    columns = Columns();
+    columns.count = count;
+    for (size_t i = 0; i < count; ++i) {
+        const std::string& name = names[i];
+        if (equalsIgnoreCase(name, "Title")) {
+            columns.title = i;
+        } else if (equalsIgnoreCase(name, "Author")) {
+            columns.author = i;
+        } else if (equalsIgnoreCase(name, "Year")) {
+            columns.year = i;
+        } else if (equalsIgnoreCase(name, "ISBN")) {
+            columns.isbn = i;
+        } else if (equalsIgnoreCase(name, "Category")) {
+            columns.category = i;
+        } else if (equalsIgnoreCase(name, "Status")) {
+            columns.status = i;
+        }
+    }
+
+    if (columns.title == SIZE_MAX || columns.author == SIZE_MAX || columns.year == SIZE_MAX ||
+        columns.isbn == SIZE_MAX) {
+        error = "header must name Title, Author, Year and ISBN columns";
+        return false;
+    }
+    return true;
+}
+
+// Parse and check one data record
+void CsvImporter::parseRecord(std::string_view record, size_t line, std::vector<std::string>& fields,
+                              Parsed& out) const {
+    out.row.line = line;
+    out.error.clear();
+    record = trimLineEnding(record);
+    out.blank = record.empty();
+    if (out.blank) {
+        return;
+    }
+
+    size_t count = 0;
+    if (!CsvFormat::splitRecord(record, fields, count)) {
+        out.error = "malformed quoting";
+        return;
+    }
+    if (count != columns.count) {
+        out.error = "expected " + std::to_string(columns.count) + " fields, found " + std::to_string(count);
+        return;
+    }
+
+    Row& row = out.row;
+    const std::string& year = fields[columns.year];
+    auto parsedYear = std::from_chars(year.data(), year.data() + year.size(), row.year);
+    if (year.empty() || parsedYear.ec != std::errc() || parsedYear.ptr != year.data() + year.size()) {
+        out.error = "invalid year '" + year + "'";
+        return;
+    }
+
+    if (!ISBN::isValid(fields[columns.isbn])) {
+        out.error = "invalid ISBN '" + fields[columns.isbn] + "'";
+        return;
+    }
+    row.normalizedIsbn = ISBN::normalize(fields[columns.isbn]);
+
+    row.available = true;
+    if (columns.status != SIZE_MAX) {
+        const std::string& status = fields[columns.status];
+        if (equalsIgnoreCase(status, "Borrowed")) {
+            row.available = false;
+        } else if (!status.empty() && !equalsIgnoreCase(status, "Available")) {
+            out.error = "invalid status '" + status + "'";
+            return;
+        }
+    }
+
+    // Swap rather than copy; fields keeps the row's old buffers for reuse
+    row.title.swap(fields[columns.title]);
+    row.author.swap(fields[columns.author]);
+    row.isbn.swap(fields[columns.isbn]);
+    if (columns.category != SIZE_MAX) {
+        row.category.swap(fields[columns.category]);
+    } else {
+        row.category.clear();
+    }
+}
+
+// Count a rejected row and keep its reason if there is room
+void CsvImporter::reject(Summary& summary, size_t line, const std::string& reason) const {
+    ++summary.rowsRejected;
+    if (summary.errors.size() < MAX_REPORTED_ERRORS) {
+        summary.errors.push_back("line " + std::to_string(line) + ": " + reason);
+    }
+}
+
+// Stream filename through the parser and into sink
+Status CsvImporter::import(const std::string& filename, const Sink& sink, Summary& summary) {
+    auto start = std::chrono::steady_clock::now();
+    summary = Summary();
+
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        summary.errors.push_back("cannot open " + filename);
+        return Status::IoError;
+    }
+
+    std::string buffer;          // unparsed bytes, starting at a record boundary
+    size_t bufferLine = 1;       // line on which buffer starts
+    bool headerRead = false;
+    bool atEnd = false;
+    std::vector<size_t> ends;    // offset just past each complete record in buffer
+    std::vector<size_t> lines;   // line on which each complete record starts
+    std::vector<Parsed> parsed;
+
+    while (!atEnd) {
+        size_t kept = buffer.size();
+        buffer.resize(kept + chunkBytes);
+        in.read(&buffer[kept], static_cast<std::streamsize>(chunkBytes));
+        buffer.resize(kept + static_cast<size_t>(in.gcount()));
+        atEnd = !in;
+
+        // A record ends at a line feed outside quotes. Doubled quotes
+        // inside a quoted field toggle twice, which leaves the state as is.
+        ends.clear();
+        lines.clear();
+        bool quoted = false;
+        size_t line = bufferLine;
+        size_t recordLine = bufferLine;
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            char c = buffer[i];
+            if (c == '"') {
+                quoted = !quoted;
+            } else if (c == '\n') {
+                ++line;
+                if (!quoted) {
+                    ends.push_back(i + 1);
+                    lines.push_back(recordLine);
+                    recordLine = line;
+                }
+            }
+        }
+        size_t complete = ends.empty() ? 0 : ends.back();
+        if (atEnd && complete < buffer.size()) {
+            // The last record need not end in a line break
+            ends.push_back(buffer.size());
+            lines.push_back(recordLine);
+            complete = buffer.size();
+        }
+
+        size_t first = 0;
+        if (!headerRead && !ends.empty()) {
+            std::string error;
+            if (!readHeader(std::string_view(buffer.data(), ends[0]), error)) {
+                summary.errors.push_back(filename + ": " + error);
+                return Status::InvalidFile;
+            }
+            headerRead = true;
+            first = 1;
+        }
+
+        // Parse this chunk's records in parallel, one contiguous range each
+        size_t records = ends.size() - first;
+        parsed.resize(records);
+        size_t ranges = pool ? std::max<size_t>(1, std::min<size_t>(pool->size(), records / MIN_RECORDS_PER_THREAD)) : 1;
+        auto parseRange = [&](size_t range) {
+            std::vector<std::string> fields;
+            for (size_t i = records * range / ranges; i < records * (range + 1) / ranges; ++i) {
+                size_t record = first + i;
+                size_t begin = record == 0 ? 0 : ends[record - 1];
+                parseRecord(std::string_view(buffer.data() + begin, ends[record] - begin), lines[record], fields,
+                            parsed[i]);
+            }
+        };
+        if (ranges > 1) {
+            pool->run(ranges, parseRange);
+        } else {
+            parseRange(0);
+        }
+
+        // Hand rows over in file order, so duplicates resolve the same way
+        // whatever the thread count
+        std::string error;
+        for (size_t i = 0; i < records; ++i) {
+            Parsed& result = parsed[i];
+            if (result.blank) {
+                continue;
+            }
+            ++summary.rowsRead;
+            if (!result.error.empty()) {
+                reject(summary, result.row.line, result.error);
+            } else if (sink(result.row, error)) {
+                ++summary.rowsImported;
+            } else {
+                reject(summary, result.row.line, error);
+            }
+        }
+
+        buffer.erase(0, complete);
+        bufferLine = recordLine;
+    }
+
+    if (!headerRead) {
+        summary.errors.push_back(filename + ": missing header");
+        return Status::InvalidFile;
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    summary.seconds = std::chrono::duration<double>(elapsed).count();
+    return Status::Ok;
+}
@@ -0,0 +1,90 @@
+#ifndef CSV_IMPORTER_H
+#define CSV_IMPORTER_H
+
+#include "Status.h"
+#include "ThreadPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Streaming RFC 4180 reader for book feeds.
+//
+// The first record is a header naming the columns; Title, Author, Year and
+// ISBN are required, Category and Status are optional and any other column
+// (such as the ID written by exportToCSV) is ignored. Fields may be quoted,
+// with "" for a quote inside a quoted field, and quoted fields may span
+// lines. Records end in LF or CRLF.
+//
+// The file is read in fixed-size chunks. The complete records of a chunk
+// are split across the thread pool, parsed and checked in parallel, then
+// passed to the sink one at a time in file order, so memory use depends on
+// the chunk size and not on the file size.
+class CsvImporter {
+public:
+    // One parsed record. ISBN has been validated and normalized.
+    struct Row {
+        size_t line;
+        std::string title;
+        std::string author;
+        int year;
+        std::string isbn;
+        std::string normalizedIsbn;
+        std::string category;
+        bool available;
+    };
+
+    struct Summary {
+        size_t rowsRead = 0;
+        size_t rowsImported = 0;
+        size_t rowsRejected = 0;
+        double seconds = 0;
+        std::vector<std::string> errors;  // the first MAX_REPORTED_ERRORS rejections
+    };
+
+    // Accepts a row (true) or rejects it with a reason
+    using Sink = std::function<bool(Row& row, std::string& error)>;
+
+    static const size_t DEFAULT_CHUNK_BYTES = 8 << 20;
+    static const size_t MAX_REPORTED_ERRORS = 10;
+
+private:
+    // Position of each required and optional column in a record
+    struct Columns {
+        size_t count = 0;
+        size_t title = SIZE_MAX;
+        size_t author = SIZE_MAX;
+        size_t year = SIZE_MAX;
+        size_t isbn = SIZE_MAX;
+        size_t category = SIZE_MAX;
+        size_t status = SIZE_MAX;
+    };
+
+    // Outcome of parsing one record
+    struct Parsed {
+        Row row;
+        bool blank;         // an empty line, skipped without counting
+        std::string error;  // empty if the row is valid
+    };
+
+    ThreadPool* pool;
+    size_t chunkBytes;
+    Columns columns;
+
+    bool readHeader(std::string_view record, std::string& error);
+    void parseRecord(std::string_view record, size_t line, std::vector<std::string>& fields, Parsed& out) const;
+    void reject(Summary& summary, size_t line, const std::string& reason) const;
+
+public:
+    // pool may be null to parse on the calling thread only
+    explicit CsvImporter(ThreadPool* pool, size_t chunkBytes = DEFAULT_CHUNK_BYTES);
+
+    // Read filename and feed every valid row to sink. IoError if the file
+    // cannot be read, InvalidFile if its header lacks a required column
+    // (the reason is in summary.errors); rejected rows do not make it fail.
+    Status import(const std::string& filename, const Sink& sink, Summary& summary);
+};
+
+#endif // CSV_IMPORTER_H
@@ -0,0 +1,838 @@
+#include "DatabaseManager.h"
+#include "CatalogFile.h"
+#include <algorithm>
+#include <cstdint>
+
+#ifdef HAVE_LIBPQ
+#include <libpq-fe.h>
+
+namespace {
+
+const Oid INT4_OID = 23;
+const Oid BOOL_OID = 16;
+
+// A statement prepared on every connection. Parameter types left 0 are
+// inferred by the server; integers and booleans are sent in binary.
+struct PreparedStatement {
+    const char* name;
+    const std::string& sql;
+    int paramCount;
+    Oid paramTypes[7];
+};
+
+const PreparedStatement STATEMENTS[] = {
+    {"insert_book", SQL::INSERT_BOOK, 6, {0, 0, INT4_OID, 0, 0, BOOL_OID}},
+    {"insert_book_with_id", SQL::INSERT_BOOK_WITH_ID, 7, {0, 0, INT4_OID, 0, 0, BOOL_OID, INT4_OID}},
+    {"update_book", SQL::UPDATE_BOOK, 7, {0, 0, INT4_OID, 0, 0, BOOL_OID, INT4_OID}},
+    {"set_availability", SQL::SET_AVAILABILITY, 2, {INT4_OID, BOOL_OID}},
+    {"delete_book", SQL::DELETE_BOOK, 1, {INT4_OID}},
+    {"delete_all", SQL::DELETE_ALL, 0, {}},
+    {"select_all", SQL::SELECT_ALL, 0, {}},
+    {"select_by_id", SQL::SELECT_BY_ID, 1, {INT4_OID}},
+    {"search_by_title", SQL::SEARCH_BY_TITLE, 1, {}},
+    {"search_by_author", SQL::SEARCH_BY_AUTHOR, 1, {}},
+    {"reserve_ids", SQL::RESERVE_IDS, 1, {INT4_OID}},
+    {"reset_id_sequence", SQL::RESET_ID_SEQUENCE, 0, {}},
+};
+
+// Bytes of COPY data buffered before they are handed to libpq
+const size_t COPY_CHUNK_BYTES = 1 << 20;
+
+// Start of a binary COPY stream: signature, flags, header extension length
+const char COPY_HEADER[19] = {'P', 'G', 'C', 'O', 'P', 'Y', '\n', '\377', '\r', '\n', '\0', 0, 0, 0, 0, 0, 0, 0, 0};
+
+// Columns of a BOOK_COLUMNS row
+enum BookColumn { ID, TITLE, AUTHOR, YEAR, ISBN, CATEGORY, IS_AVAILABLE };
+
+using Result = std::unique_ptr<PGresult, decltype(&PQclear)>;
+
+// Whether result is a success
+bool succeeded(const Result& result) {
+    ExecStatusType status = result ? PQresultStatus(result.get()) : PGRES_FATAL_ERROR;
+    return status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK;
+}
+
+// A binary int4 field
+int readInt(const PGresult* result, int row, int column) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(PQgetvalue(result, row, column));
+    return static_cast<int32_t>((uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) |
+                                (uint32_t(bytes[2]) << 8) | uint32_t(bytes[3]));
+}
+
+// A binary text field; NULL reads as empty
+std::string readText(const PGresult* result, int row, int column) {
+    if (PQgetisnull(result, row, column)) {
+        return std::string();
+    }
+    return std::string(PQgetvalue(result, row, column), PQgetlength(result, row, column));
+}
+
+// Books in the rows of a BOOK_COLUMNS result
+std::vector<Book> readBooks(const PGresult* result) {
+    std::vector<Book> books;
+    int rows = PQntuples(result);
+    books.reserve(rows);
+    for (int row = 0; row < rows; ++row) {
+        bool available = PQgetisnull(result, row, IS_AVAILABLE) || PQgetvalue(result, row, IS_AVAILABLE)[0] != 0;
+        books.emplace_back(readInt(result, row, ID), readText(result, row, TITLE), readText(result, row, AUTHOR),
+                           PQgetisnull(result, row, YEAR) ? 0 : readInt(result, row, YEAR),
+                           readText(result, row, ISBN), readText(result, row, CATEGORY), available);
+    }
+    return books;
+}
+
+// Append value to a binary COPY stream in network byte order
+void appendInt16(std::string& out, int16_t value) {
+    uint16_t bits = static_cast<uint16_t>(value);
+    out += static_cast<char>(bits >> 8);
+    out += static_cast<char>(bits);
+}
+
+void appendInt32(std::string& out, int32_t value) {
+    uint32_t bits = static_cast<uint32_t>(value);
+    out += static_cast<char>(bits >> 24);
+    out += static_cast<char>(bits >> 16);
+    out += static_cast<char>(bits >> 8);
+    out += static_cast<char>(bits);
+}
+
+// Append one field of a COPY row: its length, then its binary value
+void appendField(std::string& out, std::string_view value) {
+    appendInt32(out, static_cast<int32_t>(value.size()));
+    out.append(value.data(), value.size());
+}
+
+// Append book as a COPY_BOOKS row stored under id
+void appendCopyRow(std::string& out, const Book& book, int id) {
+    appendInt16(out, 7);
+    appendInt32(out, 4);
+    appendInt32(out, id);
+    appendField(out, book.getTitle());
+    appendField(out, book.getAuthor());
+    appendInt32(out, 4);
+    appendInt32(out, book.getYear());
+    appendField(out, book.getIsbn());
+    appendField(out, book.getCategory());
+    appendInt32(out, 1);
+    out += static_cast<char>(book.getAvailability() ? 1 : 0);
+}
+
+// Pattern for LIKE matching value anywhere, with its wildcards escaped
+std::string containsPattern(const std::string& value) {
+    std::string pattern = "%";
+    for (char c : value) {
+        if (c == '%' || c == '_' || c == '\\') {
+            pattern += '\\';
+        }
+        pattern += c;
+    }
+    pattern += '%';
+    return pattern;
+}
+
+}  // namespace
+
+// Strings are sent as text, integers and booleans in binary
+class DatabaseManager::Params {
+private:
+    std::vector<std::string> storage;
+    std::vector<int> formats;
+    std::vector<const char*> values;
+    std::vector<int> lengths;
+
+    void add(std::string value, int format) {
+        storage.push_back(std::move(value));
+        formats.push_back(format);
+    }
+
+public:
+    void addText(const std::string& value) { add(value, 0); }
+    void addInt(int value) {
+        uint32_t bits = static_cast<uint32_t>(value);
+        char bytes[4] = {static_cast<char>(bits >> 24), static_cast<char>(bits >> 16),
+                         static_cast<char>(bits >> 8), static_cast<char>(bits)};
+        add(std::string(bytes, 4), 1);
+    }
+    void addBool(bool value) { add(std::string(1, value ? 1 : 0), 1); }
+
+    // Title, author, year, ISBN, category and availability of book
+    void addBook(const Book& book) {
+        addText(std::string(book.getTitle()));
+        addText(book.getAuthor());
+        addInt(book.getYear());
+        addText(std::string(book.getIsbn()));
+        addText(book.getCategory());
+        addBool(book.getAvailability());
+    }
+
+    // Run a prepared statement with these parameters, asking for results in binary
+    Result execute(PGconn* connection, const char* statement) {
+        collect();
+        return Result(PQexecPrepared(connection, statement, static_cast<int>(storage.size()), values.data(),
+                                     lengths.data(), formats.data(), 1),
+                      PQclear);
+    }
+    
+    // Queue the statement in pipeline mode; results are read later
+    bool send(PGconn* connection, const char* statement) {
+        collect();
+        return PQsendQueryPrepared(connection, statement, static_cast<int>(storage.size()), values.data(),
+                                   lengths.data(), formats.data(), 1) == 1;
+    }
+    
+private:
+    // Point values and lengths at storage, which no longer changes
+    void collect() {
+        values.clear();
+        lengths.clear();
+        for (const auto& value : storage) {
+            values.push_back(value.c_str());
+            lengths.push_back(static_cast<int>(value.size()));
+        }
+    }
+};
+
+#endif  // HAVE_LIBPQ
+
+// Borrow a connection, waiting for one if the pool is exhausted
+DatabaseManager::Lease::Lease(DatabaseManager& manager) : manager(manager), connection(manager.acquire()) {}
+
+// Give the connection back
+DatabaseManager::Lease::~Lease() {
+    if (connection) {
+        manager.release(connection);
+    }
+}
+
+// Constructor
+DatabaseManager::DatabaseManager(const std::string& host, const std::string& database,
+                                 const std::string& username, const std::string& password)
+    : isConnected(false), poolSize(DEFAULT_POOL_SIZE), openConnections(0), bookCache(DEFAULT_CACHED_BOOKS),
+      searchCache(DEFAULT_CACHED_SEARCHES) {
+    connectionString = "host=" + host + " dbname=" + database + " user=" + username;
+    if (!password.empty()) {
+        connectionString += " password=" + password;
+    }
+}
+
+// Manager for a libpq connection string
+std::unique_ptr<DatabaseManager> DatabaseManager::fromConnectionString(const std::string& connectionString) {
+    auto manager = std::make_unique<DatabaseManager>();
+    manager->connectionString = connectionString;
+    return manager;
+}
+
+// Destructor
+DatabaseManager::~DatabaseManager() {
+    disconnect();
+}
+
+// Remember the error of the last failed call
+void DatabaseManager::setError(const std::string& message) {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    lastError = message;
+}
+
+// Description of the last error
+std::string DatabaseManager::getLastError() const {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    return lastError;
+}
+
+// Most connections open at once
+void DatabaseManager::setPoolSize(size_t connections) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    poolSize = std::max<size_t>(1, connections);
+}
+
+// Resize the caches, evicting what no longer fits
+void DatabaseManager::setCacheCapacity(size_t books, size_t searches) {
+    bookCache.setCapacity(books);
+    searchCache.setCapacity(searches);
+}
+
+// Hits, misses, evictions and entries of both caches
+DatabaseManager::CacheStats DatabaseManager::getCacheStats() {
+    auto books = bookCache.counters();
+    auto searches = searchCache.counters();
+    CacheStats stats;
+    stats.hits = books.hits + searches.hits;
+    stats.misses = books.misses + searches.misses;
+    stats.evictions = books.evictions + searches.evictions;
+    stats.entries = books.entries + searches.entries;
+    return stats;
+}
+
+// Drop what the caches hold for a book that was written, and every search,
+// since the book may now match different ones
+void DatabaseManager::bookChanged(int id) {
+    bookCache.invalidate(id);
+    searchCache.invalidateAll();
+}
+
+// Open the first connection, which checks the server can be reached
+bool DatabaseManager::connect() {
+    Lease lease(*this);
+    isConnected = static_cast<bool>(lease);
+    return isConnected;
+}
+
+// Close every connection. Calls still running keep theirs until they end.
+void DatabaseManager::disconnect() {
+    closeIdleConnections();
+    isConnected = false;
+}
+
+// Take an idle connection, open a new one if the pool has room, or wait
+pg_conn* DatabaseManager::acquire() {
+    std::unique_lock<std::mutex> lock(poolMutex);
+    connectionReleased.wait(lock, [this] { return !idleConnections.empty() || openConnections < poolSize; });
+    if (!idleConnections.empty()) {
+        pg_conn* connection = idleConnections.back();
+        idleConnections.pop_back();
+        return connection;
+    }
+
+    // Connecting takes a round trip or more, so do it without the lock
+    ++openConnections;
+    lock.unlock();
+    pg_conn* connection = openConnection();
+    if (!connection) {
+        lock.lock();
+        --openConnections;
+        connectionReleased.notify_one();
+    }
+    return connection;
+}
+
+#ifdef HAVE_LIBPQ
+
+// Connect, create the table if needed and prepare every statement
+pg_conn* DatabaseManager::openConnection() {
+    PGconn* connection = PQconnectdb(connectionString.c_str());
+    if (PQstatus(connection) != CONNECTION_OK) {
+        setError(PQerrorMessage(connection));
+        PQfinish(connection);
+        return nullptr;
+    }
+
+    // Statements cannot be prepared against a table that does not exist yet
+    if (!runCommand(connection, SQL::CREATE_BOOKS_TABLE)) {
+        PQfinish(connection);
+        return nullptr;
+    }
+    for (const auto& statement : STATEMENTS) {
+        Result result(PQprepare(connection, statement.name, statement.sql.c_str(), statement.paramCount,
+                                statement.paramTypes),
+                      PQclear);
+        if (!succeeded(result)) {
+            setError(std::string("Cannot prepare ") + statement.name + ": " + PQerrorMessage(connection));
+            PQfinish(connection);
+            return nullptr;
+        }
+    }
+    return connection;
+}
+
+// Return a connection to the pool, or close it if it broke
+void DatabaseManager::release(pg_conn* connection) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    if (PQstatus(connection) == CONNECTION_OK && PQtransactionStatus(connection) == PQTRANS_IDLE) {
+        idleConnections.push_back(connection);
+    } else {
+        PQfinish(connection);
+        --openConnections;
+    }
+    connectionReleased.notify_one();
+}
+
+// Close the connections nobody is using
+void DatabaseManager::closeIdleConnections() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    for (pg_conn* connection : idleConnections) {
+        PQfinish(connection);
+    }
+    openConnections -= idleConnections.size();
+    idleConnections.clear();
+}
+
+// Run one SQL command that takes no parameters
+bool DatabaseManager::runCommand(pg_conn* connection, const std::string& sql) {
+    Result result(PQexec(connection, sql.c_str()), PQclear);
+    if (!succeeded(result)) {
+        setError(PQerrorMessage(connection));
+        return false;
+    }
+    return true;
+}
+
+// Create the books table if it does not exist
+bool DatabaseManager::createTables() {
+    Lease lease(*this);
+    return lease && runCommand(lease.get(), SQL::CREATE_BOOKS_TABLE);
+}
+
+// Insert book and report the ID the database gave it
+bool DatabaseManager::insertBook(const Book& book, int* newId) {
+    Lease lease(*this);
+    if (!lease) {
+        return false;
+    }
+    Params params;
+    params.addBook(book);
+    Result result = params.execute(lease.get(), "insert_book");
+    searchCache.invalidateAll();
+    if (!succeeded(result) || PQntuples(result.get()) != 1) {
+        setError(PQerrorMessage(lease.get()));
+        return false;
+    }
+    if (newId) {
+        *newId = readInt(result.get(), 0, 0);
+    }
+    return true;
+}
+
+// Store every field of the book with book's ID
+bool DatabaseManager::updateBook(const Book& book) {
+    Lease lease(*this);
+    if (!lease) {
+        return false;
+    }
+    Params params;
+    params.addBook(book);
+    params.addInt(book.getId());
+    Result result = params.execute(lease.get(), "update_book");
+    bookChanged(book.getId());
+    if (!succeeded(result)) {
+        setError(PQerrorMessage(lease.get()));
+        return false;
+    }
+    return true;
+}
+
+// Mark a book borrowed or available
+bool DatabaseManager::setAvailability(int id, bool available) {
+    Lease lease(*this);
+    if (!lease) {
+        return false;
+    }
+    Params params;
+    params.addInt(id);
+    params.addBool(available);
+    Result result = params.execute(lease.get(), "set_availability");
+    bookChanged(id);
+    if (!succeeded(result)) {
+        setError(PQerrorMessage(lease.get()));
+        return false;
+    }
+    return true;
+}
+
+// Delete the book with this ID
+bool DatabaseManager::deleteBook(int id) {
+    Lease lease(*this);
+    if (!lease) {
+        return false;
+    }
+    Params params;
+    params.addInt(id);
+    Result result = params.execute(lease.get(), "delete_book");
+    bookChanged(id);
+    if (!succeeded(result)) {
+        setError(PQerrorMessage(lease.get()));
+        return false;
+    }
+    return true;
+}
+
+// Run a prepared SELECT of BOOK_COLUMNS into books
+bool DatabaseManager::queryBooks(const char* statement, Params& params, std::vector<Book>& books) {
+    Lease lease(*this);
+    if (!lease) {
+        return false;
+    }
+    Result result = params.execute(lease.get(), statement);
+    if (!succeeded(result)) {
+        setError(PQerrorMessage(lease.get()));
+        return false;
+    }
+    books = readBooks(result.get());
+    return true;
+}
+
+// Every book, by ID
+std::vector<Book> DatabaseManager::getAllBooks() {
+    std::vector<Book> books;
+    getAllBooks(books);
+    return books;
+}
+
+// Every book, reporting whether the query succeeded
+bool DatabaseManager::getAllBooks(std::vector<Book>& books) {
+    Params params;
+    books.clear();
+    return queryBooks("select_all", params, books);
+}
+
+// The book with this ID, if there is one
+std::optional<Book> DatabaseManager::getBookById(int id) {
+    std::optional<Book> book(std::in_place);
+    if (bookCache.find(id, *book)) {
+        return book;
+    }
+    
+    uint64_t generation = bookCache.generation();
+    Params params;
+    params.addInt(id);
+    std::vector<Book> books;
+    if (!queryBooks("select_by_id", params, books) || books.empty()) {
+        return std::nullopt;
+    }
+    bookCache.insert(id, books.front(), generation);
+    *book = std::move(books.front());
+    return book;
+}
+
+// Books whose title or author contains value, ignoring case
+std::vector<Book> DatabaseManager::searchBooks(const std::string& field, const std::string& value) {
+    const char* statement = field == "title" ? "search_by_title" : field == "author" ? "search_by_author" : nullptr;
+    if (!statement) {
+        setError("Cannot search by " + field + "; use title or author");
+        return {};
+    }
+    
+    // The search ignores case, so queries differing only in case share an entry
+    std::string key = field + ':' + value;
+    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+    std::vector<Book> books;
+    if (searchCache.find(key, books)) {
+        return books;
+    }
+    
+    uint64_t generation = searchCache.generation();
+    Params params;
+    params.addText(containsPattern(value));
+    if (queryBooks(statement, params, books)) {
+        searchCache.insert(key, books, generation);
+    }
+    return books;
+}
+
+// Check a connection can be made and used
+bool DatabaseManager::testConnection() {
+    Lease lease(*this);
+    return lease && runCommand(lease.get(), "SELECT 1;");
+}
+
+// Write every book to a catalog data file
+bool DatabaseManager::backup(const std::string& filename) {
+    Lease lease(*this);
+    if (!lease) {
+        return false;
+    }
+    Params params;
+    Result result = params.execute(lease.get(), "select_all");
+    if (!succeeded(result)) {
+        setError(PQerrorMessage(lease.get()));
+        return false;
+    }
+    std::vector<Book> books = readBooks(result.get());
+    int nextId = books.empty() ? 1 : books.back().getId() + 1;
+    if (!CatalogFile::write(filename, books, nextId)) {
+        setError("Cannot write " + filename);
+        return false;
+    }
+    return true;
+}
+
+// Replace every book with the contents of a catalog data file, keeping
+// their IDs. Runs in one transaction, so a failure changes nothing.
+bool DatabaseManager::restore(const std::string& filename) {
+    CatalogFile file;
+    if (!file.open(filename)) {
+        setError("Cannot open data file " + filename);
+        return false;
+    }
+    std::vector<Book> books(file.recordCount());
+    std::vector<const Book*> rows;
+    std::vector<int> ids;
+    for (size_t record = 0; record < books.size(); ++record) {
+        if (!file.readBook(record, books[record])) {
+            setError("Corrupt record in " + filename);
+            return false;
+        }
+        rows.push_back(&books[record]);
+        ids.push_back(books[record].getId());
+    }
+    
+    Lease lease(*this);
+    bool restored = lease && inTransaction(lease.get(), [&] {
+        Params none;
+        if (!succeeded(none.execute(lease.get(), "delete_all")) || !copyBooks(lease.get(), rows, ids) ||
+            !succeeded(none.execute(lease.get(), "reset_id_sequence"))) {
+            setError(PQerrorMessage(lease.get()));
+            return false;
+        }
+        return true;
+    });
+    bookCache.invalidateAll();
+    searchCache.invalidateAll();
+    return restored;
+}
+
+// Run work between BEGIN and COMMIT, rolling back if it fails
+bool DatabaseManager::inTransaction(pg_conn* connection, const std::function<bool()>& work) {
+    if (!runCommand(connection, "BEGIN;")) {
+        return false;
+    }
+    if (!work()) {
+        std::string error = getLastError();
+        runCommand(connection, "ROLLBACK;");
+        setError(error);
+        return false;
+    }
+    return runCommand(connection, "COMMIT;");
+}
+
+// Take count new IDs from the sequence
+std::vector<int> DatabaseManager::reserveIds(size_t count) {
+    std::vector<int> ids;
+    Lease lease(*this);
+    if (!lease || !reserveIdsOn(lease.get(), count, ids)) {
+        ids.clear();
+    }
+    return ids;
+}
+
+// Append count new IDs from the sequence to ids, in one round trip
+bool DatabaseManager::reserveIdsOn(pg_conn* connection, size_t count, std::vector<int>& ids) {
+    if (count == 0) {
+        return true;
+    }
+    Params params;
+    params.addInt(static_cast<int>(count));
+    Result result = params.execute(connection, "reserve_ids");
+    if (!succeeded(result) || static_cast<size_t>(PQntuples(result.get())) != count) {
+        setError(PQerrorMessage(connection));
+        return false;
+    }
+    ids.reserve(ids.size() + count);
+    for (size_t row = 0; row < count; ++row) {
+        ids.push_back(readInt(result.get(), static_cast<int>(row), 0));
+    }
+    return true;
+}
+
+// Stream books, stored under ids, through one binary COPY
+bool DatabaseManager::copyBooks(pg_conn* connection, const std::vector<const Book*>& books,
+                                const std::vector<int>& ids) {
+    Result start(PQexec(connection, SQL::COPY_BOOKS.c_str()), PQclear);
+    if (!start || PQresultStatus(start.get()) != PGRES_COPY_IN) {
+        setError(PQerrorMessage(connection));
+        return false;
+    }
+    
+    std::string buffer(COPY_HEADER, sizeof(COPY_HEADER));
+    buffer.reserve(COPY_CHUNK_BYTES + 4096);
+    bool sent = true;
+    for (size_t i = 0; i < books.size() && sent; ++i) {
+        appendCopyRow(buffer, *books[i], ids[i]);
+        if (buffer.size() >= COPY_CHUNK_BYTES) {
+            sent = PQputCopyData(connection, buffer.data(), static_cast<int>(buffer.size())) == 1;
+            buffer.clear();
+        }
+    }
+    appendInt16(buffer, -1);
+    sent = sent && PQputCopyData(connection, buffer.data(), static_cast<int>(buffer.size())) == 1;
+    if (PQputCopyEnd(connection, sent ? nullptr : "client failed to send rows") != 1) {
+        setError(PQerrorMessage(connection));
+        return false;
+    }
+    
+    // The outcome of the COPY, then nothing
+    bool ok = true;
+    while (PGresult* raw = PQgetResult(connection)) {
+        Result result(raw, PQclear);
+        if (!succeeded(result)) {
+            setError(PQresultErrorMessage(raw));
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// Run statements[i] with params[i] for every i, sending up to
+// PIPELINE_DEPTH of them before reading their results. Stops at the first
+// failure. returnedIds, if given, receives the first column of every
+// one-row result. Caller wraps the run in a transaction.
+bool DatabaseManager::runPipeline(pg_conn* connection, const std::vector<const char*>& statements,
+                                  std::vector<Params>& params, std::vector<int>* returnedIds) {
+#ifdef LIBPQ_HAS_PIPELINING
+    if (PQenterPipelineMode(connection) != 1) {
+        setError(PQerrorMessage(connection));
+        return false;
+    }
+    bool ok = true;
+    for (size_t first = 0; first < statements.size() && ok; first += PIPELINE_DEPTH) {
+        size_t last = std::min(statements.size(), first + PIPELINE_DEPTH);
+        for (size_t i = first; i < last; ++i) {
+            if (!params[i].send(connection, statements[i])) {
+                setError(PQerrorMessage(connection));
+                ok = false;
+                last = i;
+                break;
+            }
+        }
+        if (PQpipelineSync(connection) != 1) {
+            setError(PQerrorMessage(connection));
+            PQexitPipelineMode(connection);
+            return false;
+        }
+        
+        // Each statement's result is followed by a null; the sync comes last
+        for (size_t i = first; i < last; ++i) {
+            Result result(PQgetResult(connection), PQclear);
+            if (ok && !succeeded(result)) {
+                setError(result ? PQresultErrorMessage(result.get()) : PQerrorMessage(connection));
+                ok = false;
+            } else if (ok && returnedIds && PQntuples(result.get()) == 1) {
+                returnedIds->push_back(readInt(result.get(), 0, 0));
+            }
+            Result end(PQgetResult(connection), PQclear);
+        }
+        Result sync(PQgetResult(connection), PQclear);
+    }
+    PQexitPipelineMode(connection);
+    return ok;
+#else
+    // libpq before 14: one round trip per statement
+    for (size_t i = 0; i < statements.size(); ++i) {
+        Result result = params[i].execute(connection, statements[i]);
+        if (!succeeded(result)) {
+            setError(PQerrorMessage(connection));
+            return false;
+        }
+        if (returnedIds && PQntuples(result.get()) == 1) {
+            returnedIds->push_back(readInt(result.get(), 0, 0));
+        }
+    }
+    return true;
+#endif
+}
+
+// Store many books in one transaction
+bool DatabaseManager::insertBooks(const std::vector<const Book*>& books, std::vector<int>* newIds,
+                                  BulkMethod method) {
+    Lease lease(*this);
+    if (!lease) {
+        return false;
+    }
+    pg_conn* connection = lease.get();
+    std::vector<int> ids;
+    ids.reserve(books.size());
+    bool stored = inTransaction(connection, [&] {
+        if (method == BulkMethod::Copy) {
+            // COPY cannot return generated IDs, so take them from the sequence first
+            size_t unnumbered = std::count_if(books.begin(), books.end(),
+                                              [](const Book* book) { return book->getId() == 0; });
+            std::vector<int> reserved;
+            if (!reserveIdsOn(connection, unnumbered, reserved)) {
+                return false;
+            }
+            auto next = reserved.begin();
+            for (const Book* book : books) {
+                ids.push_back(book->getId() != 0 ? book->getId() : *next++);
+            }
+            return copyBooks(connection, books, ids);
+        }
+        
+        std::vector<const char*> statements;
+        std::vector<Params> params(books.size());
+        statements.reserve(books.size());
+        for (size_t i = 0; i < books.size(); ++i) {
+            params[i].addBook(*books[i]);
+            if (books[i]->getId() != 0) {
+                params[i].addInt(books[i]->getId());
+                statements.push_back("insert_book_with_id");
+            } else {
+                statements.push_back("insert_book");
+            }
+        }
+        std::vector<int> generated;
+        if (!runPipeline(connection, statements, params, &generated)) {
+            return false;
+        }
+        auto next = generated.begin();
+        for (const Book* book : books) {
+            ids.push_back(book->getId() != 0 ? book->getId() : *next++);
+        }
+        return true;
+    });
+    searchCache.invalidateAll();
+    if (stored && newIds) {
+        *newIds = std::move(ids);
+    }
+    return stored;
+}
+
+// Store many books held by value
+bool DatabaseManager::insertBooks(const std::vector<Book>& books, std::vector<int>* newIds, BulkMethod method) {
+    std::vector<const Book*> rows;
+    rows.reserve(books.size());
+    for (const Book& book : books) {
+        rows.push_back(&book);
+    }
+    return insertBooks(rows, newIds, method);
+}
+
+// Store every field of many books, pipelined in one transaction
+bool DatabaseManager::updateBooks(const std::vector<Book>& books) {
+    Lease lease(*this);
+    if (!lease) {
+        return false;
+    }
+    std::vector<const char*> statements(books.size(), "update_book");
+    std::vector<Params> params(books.size());
+    for (size_t i = 0; i < books.size(); ++i) {
+        params[i].addBook(books[i]);
+        params[i].addInt(books[i].getId());
+    }
+    bool updated = inTransaction(lease.get(), [&] { return runPipeline(lease.get(), statements, params, nullptr); });
+    for (const Book& book : books) {
+        bookCache.invalidate(book.getId());
+    }
+    searchCache.invalidateAll();
+    return updated;
+}
+
+#else  // no libpq: every operation fails
+
+namespace {
+const char* NO_LIBPQ = "Built without PostgreSQL support (libpq); rebuild with POSTGRES=1";
+}
+
+pg_conn* DatabaseManager::openConnection() {
+    setError(NO_LIBPQ);
+    return nullptr;
+}
+
+void DatabaseManager::release(pg_conn*) {}
+void DatabaseManager::closeIdleConnections() {}
+bool DatabaseManager::createTables() { return false; }
+bool DatabaseManager::insertBook(const Book&, int*) { return false; }
+bool DatabaseManager::updateBook(const Book&) { return false; }
+bool DatabaseManager::setAvailability(int, bool) { return false; }
+bool DatabaseManager::deleteBook(int) { return false; }
+std::vector<Book> DatabaseManager::getAllBooks() { return {}; }
+bool DatabaseManager::getAllBooks(std::vector<Book>& books) { books.clear(); return false; }
+std::optional<Book> DatabaseManager::getBookById(int) { return std::nullopt; }
+std::vector<Book> DatabaseManager::searchBooks(const std::string&, const std::string&) { return {}; }
+bool DatabaseManager::testConnection() { return false; }
+bool DatabaseManager::backup(const std::string&) { return false; }
+bool DatabaseManager::restore(const std::string&) { return false; }
+bool DatabaseManager::insertBooks(const std::vector<const Book*>&, std::vector<int>*, BulkMethod) { return false; }
+bool DatabaseManager::insertBooks(const std::vector<Book>&, std::vector<int>*, BulkMethod) { return false; }
+bool DatabaseManager::updateBooks(const std::vector<Book>&) { return false; }
+std::vector<int> DatabaseManager::reserveIds(size_t) { return {}; }
+
+#endif  // HAVE_LIBPQ
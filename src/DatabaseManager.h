@@ -2,46 +2,167 @@
 #define DATABASE_MANAGER_H
 
 #include "Book.h"
+#include "LruCache.h"
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <vector>
 #include <string>
 
+struct pg_conn;
+
+// Book storage in PostgreSQL through libpq.
+//
+// Connections are opened on demand, up to the pool size, and shared by
+// concurrent callers: each call borrows one for its duration, waiting if
+// all are busy. Every statement in SQL:: is prepared once per connection
+// when it is opened, and rows come back in binary format, so a call costs
+// one round trip with no parsing or planning on either side.
+//
+// getBookById and searchBooks read through LRU caches keyed by book ID and
+// by search. Writes made through this manager drop the changed book and
+// every cached search; changes made by other clients of the database are
+// not seen until the entries are evicted.
+//
+// All methods are thread-safe. Without libpq (built with POSTGRES=0)
+// connect fails and every operation reports an error.
 class DatabaseManager {
 private:
     std::string connectionString;
     bool isConnected;
+
+    // Connection pool
+    size_t poolSize;
+    size_t openConnections;
+    std::vector<pg_conn*> idleConnections;
+    std::mutex poolMutex;
+    std::condition_variable connectionReleased;
+
+    mutable std::mutex errorMutex;
+    std::string lastError;
     
+    LruCache<int, Book> bookCache;
+    LruCache<std::string, std::vector<Book>> searchCache;  // "field:lowercased value" -> results
+
+    // Connection borrowed from the pool for one call
+    class Lease {
+    private:
+        DatabaseManager& manager;
+        pg_conn* connection;
+
+    public:
+        explicit Lease(DatabaseManager& manager);
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        pg_conn* get() const { return connection; }
+        explicit operator bool() const { return connection != nullptr; }
+    };
+
+    // Parameters of one statement call, defined with the libpq code
+    class Params;
+
+    pg_conn* openConnection();
+    pg_conn* acquire();
+    void release(pg_conn* connection);
+    void closeIdleConnections();
+    void setError(const std::string& message);
+    bool runCommand(pg_conn* connection, const std::string& sql);
+    bool queryBooks(const char* statement, Params& params, std::vector<Book>& books);
+    void bookChanged(int id);
+    bool reserveIdsOn(pg_conn* connection, size_t count, std::vector<int>& ids);
+    bool copyBooks(pg_conn* connection, const std::vector<const Book*>& books, const std::vector<int>& ids);
+    bool runPipeline(pg_conn* connection, const std::vector<const char*>& statements, std::vector<Params>& params,
+                     std::vector<int>* returnedIds);
+    bool inTransaction(pg_conn* connection, const std::function<bool()>& work);
+
 public:
-    // Constructor
-    DatabaseManager(const std::string& host = "localhost", 
-                   const std::string& database = "library_db",
-                   const std::string& username = "postgres", 
-                   const std::string& password = "ValyK.336");
+    static const size_t DEFAULT_POOL_SIZE = 4;
+    // Statements sent ahead of their results in a pipeline
+    static const size_t PIPELINE_DEPTH = 256;
+    static const size_t DEFAULT_CACHED_BOOKS = 10000;
+    static const size_t DEFAULT_CACHED_SEARCHES = 1000;
+    
+    // Cache activity, summed over the book and search caches
+    struct CacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+    };
     
+    // How insertBooks sends a batch
+    enum class BulkMethod {
+        Copy,      // one COPY FROM STDIN in binary format; fastest, for loads
+        Pipeline   // prepared INSERTs sent without waiting for each result
+    };
+
+    // Constructor. An empty password leaves it to libpq (PGPASSWORD or
+    // ~/.pgpass). Nothing is connected until connect().
+    DatabaseManager(const std::string& host = "localhost",
+                   const std::string& database = "library_db",
+                   const std::string& username = "postgres",
+                   const std::string& password = "");
+
+    // Connect with a libpq connection string or URI instead of the fields
+    // above, e.g. "host=/tmp dbname=library_test" or "postgresql://..."
+    static std::unique_ptr<DatabaseManager> fromConnectionString(const std::string& connectionString);
+
     // Destructor
     ~DatabaseManager();
-    Valyk.336
+
     // Connection management
     bool connect();
     void disconnect();
     bool isConnectionActive() const { return isConnected; }
-    
-    // Database operations (to be implemented with libpq)
+    // Most connections open at once; set before connect()
+    void setPoolSize(size_t connections);
+    size_t getPoolSize() const { return poolSize; }
+
+    // Database operations. insertBook stores book under a new ID from the
+    // database and returns it through newId; the book's own ID is ignored.
     bool createTables();
-    bool insertBook(const Book& book);
+    bool insertBook(const Book& book, int* newId = nullptr);
     bool updateBook(const Book& book);
+    bool setAvailability(int id, bool available);
     bool deleteBook(int id);
     std::vector<Book> getAllBooks();
-    Book getBookById(int id);
+    // Every book into books; false, with books empty, if they could not be read
+    bool getAllBooks(std::vector<Book>& books);
+    std::optional<Book> getBookById(int id);
+    
+    // Batch operations, each one transaction: if any book is rejected
+    // nothing is stored. insertBooks gives books with ID 0 new IDs from the
+    // database and stores the others under their own; newIds, if given,
+    // receives every book's ID in order.
+    bool insertBooks(const std::vector<const Book*>& books, std::vector<int>* newIds = nullptr,
+                     BulkMethod method = BulkMethod::Copy);
+    bool insertBooks(const std::vector<Book>& books, std::vector<int>* newIds = nullptr,
+                     BulkMethod method = BulkMethod::Copy);
+    bool updateBooks(const std::vector<Book>& books);
+    // Take count new IDs from the books ID sequence, for books to be stored
+    // later under those IDs
+    std::vector<int> reserveIds(size_t count);
+    // Case-insensitive substring search; field is "title" or "author"
     std::vector<Book> searchBooks(const std::string& field, const std::string& value);
+
+    // Read-through caches; a capacity of 0 turns a cache off
+    void setCacheCapacity(size_t books, size_t searches);
+    CacheStats getCacheStats();
     
     // Utility methods
     bool testConnection();
     std::string getLastError() const;
-    void backup(const std::string& filename);
-    void restore(const std::string& filename);
+    // Copy the table to a catalog data file, or replace it with one
+    bool backup(const std::string& filename);
+    bool restore(const std::string& filename);
 };
 
-// SQL queries for PostgreSQL integration
+// SQL queries for PostgreSQL integration. Statements after CREATE_BOOKS_TABLE
+// are prepared on every connection; SELECTs list BOOK_COLUMNS in this order.
 namespace SQL {
     const std::string CREATE_BOOKS_TABLE = R"(
         CREATE TABLE IF NOT EXISTS books (
@@ -56,26 +177,47 @@ namespace SQL {
             updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
         );
     )";
-    
+
+#define BOOK_COLUMNS "id, title, author, year, isbn, category, is_available"
+
     const std::string INSERT_BOOK = R"(
-        INSERT INTO books (title, author, year, isbn, category, is_available) 
+        INSERT INTO books (title, author, year, isbn, category, is_available)
         VALUES ($1, $2, $3, $4, $5, $6) RETURNING id;
     )";
-    
+
+    const std::string INSERT_BOOK_WITH_ID = R"(
+        INSERT INTO books (title, author, year, isbn, category, is_available, id)
+        VALUES ($1, $2, $3, $4, $5, $6, $7);
+    )";
+
     const std::string UPDATE_BOOK = R"(
-        UPDATE books SET title = $1, author = $2, year = $3, isbn = $4, 
-                        category = $5, is_available = $6, updated_at = CURRENT_TIMESTAMP 
+        UPDATE books SET title = $1, author = $2, year = $3, isbn = $4,
+                        category = $5, is_available = $6, updated_at = CURRENT_TIMESTAMP
         WHERE id = $7;
     )";
-    
+
+    const std::string SET_AVAILABILITY = R"(
+        UPDATE books SET is_available = $2, updated_at = CURRENT_TIMESTAMP WHERE id = $1;
+    )";
+
     const std::string DELETE_BOOK = "DELETE FROM books WHERE id = $1;";
-    const std::string SELECT_ALL = "SELECT * FROM books ORDER BY id;";
-    const std::string SELECT_BY_ID = "SELECT * FROM books WHERE id = $1;";
-    const std::string SEARCH_BY_TITLE = "SELECT * FROM books WHERE LOWER(title) LIKE LOWER($1);";
-    const std::string SEARCH_BY_AUTHOR = "SELECT * FROM books WHERE LOWER(author) LIKE LOWER($1);";
+    const std::string DELETE_ALL = "DELETE FROM books;";
+    const std::string SELECT_ALL = "SELECT " BOOK_COLUMNS " FROM books ORDER BY id;";
+    const std::string SELECT_BY_ID = "SELECT " BOOK_COLUMNS " FROM books WHERE id = $1;";
+    const std::string SEARCH_BY_TITLE = "SELECT " BOOK_COLUMNS " FROM books WHERE LOWER(title) LIKE LOWER($1) ORDER BY id;";
+    const std::string SEARCH_BY_AUTHOR = "SELECT " BOOK_COLUMNS " FROM books WHERE LOWER(author) LIKE LOWER($1) ORDER BY id;";
     const std::string COUNT_TOTAL = "SELECT COUNT(*) FROM books;";
     const std::string COUNT_AVAILABLE = "SELECT COUNT(*) FROM books WHERE is_available = true;";
+    const std::string RESERVE_IDS =
+        "SELECT nextval(pg_get_serial_sequence('books', 'id'))::int4 FROM generate_series(1, $1);";
+    // Not prepared: COPY takes no parameters and streams its rows
+    const std::string COPY_BOOKS =
+        "COPY books (id, title, author, year, isbn, category, is_available) FROM STDIN (FORMAT binary);";
+    // Point the ID sequence past the highest ID, after inserts with explicit IDs
+    const std::string RESET_ID_SEQUENCE =
+        "SELECT setval(pg_get_serial_sequence('books', 'id'), COALESCE(MAX(id), 0) + 1, false) FROM books;";
+
+#undef BOOK_COLUMNS
 }
 
 #endif // DATABASE_MANAGER_H
-
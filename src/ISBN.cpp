@@ -0,0 +1,93 @@
+#include "ISBN.h"
+
+namespace {
+
+const size_t MAX_DIGITS = 13;
+
+// Copy the significant characters of isbn into digits, skipping separators.
+// Returns the number of characters copied, or 0 if the input is malformed.
+size_t extractDigits(std::string_view isbn, char (&digits)[MAX_DIGITS]) {
+    size_t count = 0;
+    for (char c : isbn) {
+        if (c == '-' || c == ' ') {
+            continue;
+        }
+        if (count == MAX_DIGITS) {
+            return 0;
+        }
+        bool isDigit = c >= '0' && c <= '9';
+        bool isCheckX = (c == 'X' || c == 'x') && count == 9;
+        if (!isDigit && !isCheckX) {
+            return 0;
+        }
+        digits[count++] = c;
+    }
+    // 'X' is only meaningful as the last character of an ISBN-10
+    if (count != 10 && count != 13) {
+        return 0;
+    }
+    if (count == 13 && (digits[9] == 'X' || digits[9] == 'x')) {
+        return 0;
+    }
+    return count;
+}
+
+bool isbn10ChecksumOk(const char* digits) {
+    int sum = 0;
+    for (int i = 0; i < 10; ++i) {
+        int value = (digits[i] == 'X' || digits[i] == 'x') ? 10 : digits[i] - '0';
+        sum += value * (10 - i);
+    }
+    return sum % 11 == 0;
+}
+
+bool isbn13ChecksumOk(const char* digits) {
+    int sum = 0;
+    for (int i = 0; i < 13; ++i) {
+        sum += (digits[i] - '0') * (i % 2 == 0 ? 1 : 3);
+    }
+    return sum % 10 == 0;
+}
+
+}  // namespace
+
+// Validate format and check digit
+bool ISBN::isValid(std::string_view isbn) {
+    char digits[MAX_DIGITS];
+    size_t count = extractDigits(isbn, digits);
+    if (count == 10) {
+        return isbn10ChecksumOk(digits);
+    }
+    if (count == 13) {
+        return isbn13ChecksumOk(digits);
+    }
+    return false;
+}
+
+// Convert to canonical ISBN-13 form
+std::string ISBN::normalize(std::string_view isbn) {
+    char digits[MAX_DIGITS];
+    size_t count = extractDigits(isbn, digits);
+    
+    if (count == 10 && isbn10ChecksumOk(digits)) {
+        std::string result = "978";
+        result.append(digits, 9);
+        int sum = 0;
+        for (int i = 0; i < 12; ++i) {
+            sum += (result[i] - '0') * (i % 2 == 0 ? 1 : 3);
+        }
+        result += static_cast<char>('0' + (10 - sum % 10) % 10);
+        return result;
+    }
+    if (count == 13) {
+        return std::string(digits, count);
+    }
+    
+    std::string stripped;
+    for (char c : isbn) {
+        if (c != '-' && c != ' ') {
+            stripped += c;
+        }
+    }
+    return stripped;
+}
@@ -0,0 +1,20 @@
+#ifndef ISBN_H
+#define ISBN_H
+
+#include <string>
+#include <string_view>
+
+// ISBN validation and normalization helpers.
+// Hyphens and spaces are accepted as group separators and ignored.
+namespace ISBN {
+    // True if isbn is a well-formed ISBN-10 or ISBN-13 with a correct check digit.
+    // Does not allocate.
+    bool isValid(std::string_view isbn);
+    
+    // Canonical form used for uniqueness checks: separators stripped and
+    // ISBN-10 mapped to its 978-prefixed ISBN-13. Input that is not a valid
+    // ISBN is returned with separators stripped only.
+    std::string normalize(std::string_view isbn);
+}
+
+#endif // ISBN_H
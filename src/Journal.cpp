@@ -0,0 +1,421 @@
+#include "Journal.h"
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+struct FrameHeader {
+    uint32_t length;
+    uint32_t checksum;
+};
+
+// Records larger than this are treated as corruption
+const uint32_t MAX_PAYLOAD = 1 << 20;
+
+// FNV-1a over the payload
+uint32_t checksumOf(const char* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void putString(std::string& out, std::string_view value) {
+    put(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+// Bounds-checked reader over one payload
+class PayloadReader {
+private:
+    const char* cursor;
+    const char* end;
+    
+public:
+    PayloadReader(const char* data, size_t length) : cursor(data), end(data + length) {}
+    
+    template <typename T>
+    bool get(T& value) {
+        if (static_cast<size_t>(end - cursor) < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, cursor, sizeof(T));
+        cursor += sizeof(T);
+        return true;
+    }
+    
+    bool getString(std::string& value) {
+        uint32_t length;
+        if (!get(length) || static_cast<size_t>(end - cursor) < length) {
+            return false;
+        }
+        value.assign(cursor, length);
+        cursor += length;
+        return true;
+    }
+};
+
+bool decodePayload(const char* data, size_t length, Journal::Operation& op, Book& book) {
+    PayloadReader reader(data, length);
+    uint8_t opCode;
+    int32_t id;
+    if (!reader.get(opCode) || !reader.get(id)) {
+        return false;
+    }
+    op = static_cast<Journal::Operation>(opCode);
+    book = Book();
+    book.setId(id);
+    
+    if (op == Journal::Operation::Add || op == Journal::Operation::Update) {
+        int32_t year;
+        uint8_t available;
+        std::string title, author, isbn, category;
+        if (!reader.get(year) || !reader.get(available) || !reader.getString(title) ||
+            !reader.getString(author) || !reader.getString(isbn) || !reader.getString(category)) {
+            return false;
+        }
+        book = Book(id, title, author, year, isbn, category, available != 0);
+        return true;
+    }
+    return op == Journal::Operation::Delete || op == Journal::Operation::Borrow ||
+           op == Journal::Operation::Return;
+}
+
+// Read every intact record; stops at the first torn or corrupt one.
+// Returns the byte offset just past the last intact record. intact is
+// cleared if the file cannot be read, or if the bad record is not a torn
+// last write: its frame ends before the end of the file and something
+// other than zeros follows it.
+uint64_t scan(const std::string& filename, const std::function<void(Journal::Operation, const Book&)>& apply,
+              size_t& records, bool& intact) {
+    records = 0;
+    intact = true;
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        intact = false;
+        return 0;
+    }
+    
+    uint64_t validEnd = 0;
+    uint64_t claimedEnd = UINT64_MAX;  // where the first bad record says it ends
+    std::vector<char> payload;
+    FrameHeader frame;
+    while (in.read(reinterpret_cast<char*>(&frame), sizeof(frame))) {
+        claimedEnd = validEnd + sizeof(frame) + frame.length;
+        if (frame.length == 0 || frame.length > MAX_PAYLOAD) {
+            break;
+        }
+        payload.resize(frame.length);
+        if (!in.read(payload.data(), frame.length) ||
+            checksumOf(payload.data(), frame.length) != frame.checksum) {
+            break;
+        }
+        
+        Journal::Operation op;
+        Book book;
+        if (!decodePayload(payload.data(), frame.length, op, book)) {
+            break;
+        }
+        if (apply) {
+            apply(op, book);
+        }
+        ++records;
+        validEnd += sizeof(frame) + frame.length;
+        claimedEnd = UINT64_MAX;
+    }
+    
+    in.clear();
+    in.seekg(0, std::ios::end);
+    uint64_t fileSize = static_cast<uint64_t>(in.tellg());
+    if (claimedEnd < fileSize) {
+        in.seekg(static_cast<std::streamoff>(claimedEnd));
+        char byte;
+        while (in.get(byte)) {
+            if (byte != 0) {
+                intact = false;
+                break;
+            }
+        }
+    }
+    return validEnd;
+}
+
+}  // namespace
+
+// Constructor
+Journal::Journal(const std::string& filename)
+    : filename(filename), fd(-1), bytes(0), records(0), failed(false),
+      durability(Durability::Periodic), syncInterval(1000),
+      pendingBatch(std::make_shared<Batch>()), appendedSequence(0), durableSequence(0), flushing(false),
+      stopSyncer(false), dirty(false) {}
+
+// Destructor
+Journal::~Journal() {
+    close();
+}
+
+// Open for appending, cutting off a torn last record
+bool Journal::open() {
+    close();
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    failed = false;
+    fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool intact = true;
+    bytes = scan(filename, nullptr, records, intact);
+    if (!intact || ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    if (durability == Durability::Periodic) {
+        startSyncer();
+    }
+    return true;
+}
+
+// Sync anything outstanding and close the journal file
+void Journal::close() {
+    stopSyncerThread();
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    committed.wait(lock, [this] { return !flushing; });
+    if (fd >= 0) {
+        if (dirty) {
+            fdatasync(fd);
+            dirty = false;
+        }
+        ::close(fd);
+    }
+    fd = -1;
+}
+
+// write() all of data, retrying on short writes
+bool Journal::writeAll(const char* data, size_t length) {
+    size_t written = 0;
+    while (written < length) {
+        ssize_t result = ::write(fd, data + written, length - written);
+        if (result < 0) {
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+// Cut the file back to offset after a failed write or sync; caller holds
+// the mutex. If it cannot be cut, stop appending: later records would
+// follow a torn one and be lost on replay.
+void Journal::cutBack(uint64_t offset) {
+    if (ftruncate(fd, static_cast<off_t>(offset)) != 0) {
+        failed = true;
+    }
+}
+
+// Frame one payload and make it as durable as the current mode requires
+bool Journal::writeRecord(const std::string& payload) {
+    FrameHeader frame = {static_cast<uint32_t>(payload.size()), checksumOf(payload.data(), payload.size())};
+    std::string record;
+    record.reserve(sizeof(frame) + payload.size());
+    record.append(reinterpret_cast<const char*>(&frame), sizeof(frame));
+    record.append(payload);
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    if (fd < 0 || failed) {
+        return false;
+    }
+    
+    if (durability == Durability::GroupCommit) {
+        return commitGroup(lock, record);
+    }
+    
+    if (!writeAll(record.data(), record.size()) ||
+        (durability == Durability::PerOperation && fdatasync(fd) != 0)) {
+        cutBack(bytes);
+        return false;
+    }
+    bytes += record.size();
+    ++records;
+    
+    if (durability == Durability::PerOperation) {
+        return true;
+    }
+    dirty = true;
+    return true;
+}
+
+// Queue record for the next group sync and wait until it is durable. The
+// first waiter to find no sync in flight becomes the leader and writes and
+// syncs everything queued so far in one go.
+bool Journal::commitGroup(std::unique_lock<std::mutex>& lock, const std::string& record) {
+    std::shared_ptr<Batch> joined = pendingBatch;
+    joined->records.append(record);
+    ++joined->count;
+    bytes += record.size();
+    ++records;
+    uint64_t sequence = ++appendedSequence;
+    
+    while (durableSequence < sequence) {
+        if (flushing) {
+            committed.wait(lock);
+            continue;
+        }
+        
+        flushing = true;
+        std::shared_ptr<Batch> batch = std::move(pendingBatch);
+        pendingBatch = std::make_shared<Batch>();
+        uint64_t batchThrough = appendedSequence;
+        uint64_t batchStart = bytes - batch->records.size();
+        
+        bool ok = false;
+        if (!failed) {
+            lock.unlock();
+            ok = writeAll(batch->records.data(), batch->records.size()) && fdatasync(fd) == 0;
+            lock.lock();
+            if (!ok) {
+                cutBack(batchStart);
+                bytes -= batch->records.size();
+                records -= batch->count;
+            }
+        }
+        batch->failed = !ok;
+        durableSequence = batchThrough;
+        flushing = false;
+        committed.notify_all();
+    }
+    return !joined->failed;
+}
+
+// Append a record carrying the full book
+bool Journal::append(Operation op, const Book& book) {
+    std::string payload;
+    put(payload, static_cast<uint8_t>(op));
+    put(payload, static_cast<int32_t>(book.getId()));
+    if (op == Operation::Add || op == Operation::Update) {
+        put(payload, static_cast<int32_t>(book.getYear()));
+        put(payload, static_cast<uint8_t>(book.getAvailability() ? 1 : 0));
+        putString(payload, book.getTitle());
+        putString(payload, book.getAuthor());
+        putString(payload, book.getIsbn());
+        putString(payload, book.getCategory());
+    }
+    return writeRecord(payload);
+}
+
+// Append a record carrying only a book ID
+bool Journal::append(Operation op, int id) {
+    std::string payload;
+    put(payload, static_cast<uint8_t>(op));
+    put(payload, static_cast<int32_t>(id));
+    return writeRecord(payload);
+}
+
+// Replay every intact record
+size_t Journal::replay(const std::function<void(Operation, const Book&)>& apply) const {
+    size_t applied = 0;
+    bool intact = true;
+    scan(filename, apply, applied, intact);
+    return applied;
+}
+
+// Drop all records
+bool Journal::truncate() {
+    std::unique_lock<std::mutex> lock(mutex);
+    committed.wait(lock, [this] { return !flushing; });
+    if (fd < 0 || ftruncate(fd, 0) != 0) {
+        return false;
+    }
+    bytes = 0;
+    records = 0;
+    failed = false;
+    dirty = false;
+    return true;
+}
+
+// Switch durability mode; records already appended keep the old guarantee
+void Journal::setDurability(Durability mode, std::chrono::milliseconds interval) {
+    stopSyncerThread();
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    committed.wait(lock, [this] { return !flushing; });
+    durability = mode;
+    syncInterval = interval;
+    if (durability == Durability::Periodic && fd >= 0) {
+        startSyncer();
+    }
+}
+
+// Current durability mode
+Journal::Durability Journal::getDurability() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return durability;
+}
+
+// Force everything written so far to stable storage
+bool Journal::sync() {
+    std::unique_lock<std::mutex> lock(mutex);
+    committed.wait(lock, [this] { return !flushing; });
+    if (fd < 0) {
+        return false;
+    }
+    dirty = false;
+    return fdatasync(fd) == 0;
+}
+
+// Journal size in bytes
+uint64_t Journal::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytes;
+}
+
+// Number of records in the journal
+size_t Journal::recordCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return records;
+}
+
+// Start the periodic sync thread (mutex held by caller)
+void Journal::startSyncer() {
+    stopSyncer = false;
+    syncer = std::thread(&Journal::runSyncer, this);
+}
+
+// Stop the periodic sync thread if it is running (mutex not held)
+void Journal::stopSyncerThread() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopSyncer = true;
+    }
+    syncerWake.notify_all();
+    if (syncer.joinable()) {
+        syncer.join();
+    }
+}
+
+// Periodic mode: sync every interval if anything was written
+void Journal::runSyncer() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopSyncer) {
+        syncerWake.wait_for(lock, syncInterval);
+        if (dirty && fd >= 0) {
+            dirty = false;
+            int syncFd = fd;
+            lock.unlock();
+            fdatasync(syncFd);
+            lock.lock();
+        }
+    }
+}
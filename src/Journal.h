@@ -0,0 +1,122 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "Book.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Append-only write-ahead log of catalog mutations.
+//
+// Each record is framed as [payload length][checksum][payload] so a torn
+// write at the end of the file (crash mid-append) is detected and dropped on
+// open. A bad record anywhere else is damage, and open fails rather than
+// drop the records after it. Replaying is idempotent: applying the same records on top of a data
+// file that already contains them gives the same catalog.
+//
+// How soon an appended record reaches stable storage is set by Durability:
+//   None          write() only; the OS decides when to flush
+//   Periodic      write() now, fdatasync() from a background thread every interval
+//   GroupCommit   append() returns once the record is synced; records appended
+//                 while a sync is in flight share the next single write + sync
+//   PerOperation  write() and fdatasync() for every record
+// Appending is thread-safe in every mode. A record whose write or sync fails
+// is cut back off the file, so later records still follow the last intact
+// one; if even that fails, appends are refused until truncate() or open().
+class Journal {
+public:
+    enum class Operation : uint8_t {
+        Add = 1,
+        Update = 2,
+        Delete = 3,
+        Borrow = 4,
+        Return = 5
+    };
+    
+    enum class Durability {
+        None,
+        Periodic,
+        GroupCommit,
+        PerOperation
+    };
+    
+private:
+    std::string filename;
+    int fd;
+    uint64_t bytes;      // size of the valid part of the file, including pending records
+    size_t records;      // records in the valid part of the file, including pending records
+    bool failed;         // a failed record could not be cut off; appends are refused
+    
+    Durability durability;
+    std::chrono::milliseconds syncInterval;
+    mutable std::mutex mutex;
+    
+    // Records written and synced together by one group commit leader. Each
+    // waiter keeps the batch its record joined, to learn whether it failed.
+    struct Batch {
+        std::string records;
+        size_t count = 0;
+        bool failed = false;
+    };
+    
+    // Group commit state: records waiting for the next leader to write and sync
+    std::condition_variable committed;
+    std::shared_ptr<Batch> pendingBatch;
+    uint64_t appendedSequence;
+    uint64_t durableSequence;
+    bool flushing;
+    
+    // Periodic sync thread
+    std::condition_variable syncerWake;
+    std::thread syncer;
+    bool stopSyncer;
+    bool dirty;
+    
+    bool writeRecord(const std::string& payload);
+    bool writeAll(const char* data, size_t length);
+    void cutBack(uint64_t offset);
+    bool commitGroup(std::unique_lock<std::mutex>& lock, const std::string& record);
+    void startSyncer();
+    void stopSyncerThread();
+    void runSyncer();
+    
+public:
+    // Constructor
+    explicit Journal(const std::string& filename);
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+    
+    // Destructor
+    ~Journal();
+    
+    // Open (creating if needed) for appending; drops a torn tail record.
+    // False, leaving the file as it was, if it cannot be read or is damaged.
+    bool open();
+    void close();
+    bool isOpen() const { return fd >= 0; }
+    
+    // Append one record. Add and Update carry the full book, the others only its ID.
+    bool append(Operation op, const Book& book);
+    bool append(Operation op, int id);
+    
+    // Call apply for every record in order; returns the number applied
+    size_t replay(const std::function<void(Operation, const Book&)>& apply) const;
+    
+    // Discard all records (after a checkpoint has written them to the data file)
+    bool truncate();
+    
+    // Durability control
+    void setDurability(Durability mode, std::chrono::milliseconds interval = std::chrono::milliseconds(1000));
+    Durability getDurability() const;
+    bool sync();
+    
+    uint64_t size() const;
+    size_t recordCount() const;
+};
+
+#endif // JOURNAL_H
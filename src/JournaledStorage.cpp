@@ -0,0 +1,74 @@
+#include "JournaledStorage.h"
+
+// Constructor
+JournaledStorage::JournaledStorage(const std::string& filename)
+    : MappedFileStorage(filename), journal(filename + ".journal") {}
+
+// Map the data file and open the journal for appending
+bool JournaledStorage::open() {
+    if (!MappedFileStorage::open()) {
+        return false;
+    }
+    if (!journal.open()) {
+        report(true, "Cannot open journal for " + filename +
+                         ": it is unreadable or damaged; it has been left as it was.");
+        return false;
+    }
+    return true;
+}
+
+// Whether the last session left operations in the journal
+bool JournaledStorage::needsRecovery() const {
+    return journal.isOpen() && journal.recordCount() > 0;
+}
+
+// Apply operations left in the journal by a session that did not checkpoint
+size_t JournaledStorage::recover(const std::function<void(Journal::Operation, const Book&)>& apply) {
+    size_t applied = journal.replay(apply);
+    report(false, "Recovered " + std::to_string(applied) + " operations from journal.");
+    return applied;
+}
+
+// Journal an add or update
+bool JournaledStorage::record(Journal::Operation op, const Book& book) {
+    if (!journal.append(op, book)) {
+        if (journal.isOpen()) {
+            report(true, "Cannot write to journal for " + filename);
+        }
+        return false;
+    }
+    return true;
+}
+
+// Journal a delete, borrow or return; safe from several threads at once
+bool JournaledStorage::record(Journal::Operation op, int id) {
+    if (!journal.append(op, id)) {
+        if (journal.isOpen()) {
+            report(true, "Cannot write to journal for " + filename);
+        }
+        return false;
+    }
+    return true;
+}
+
+// Size of the journal
+uint64_t JournaledStorage::pendingBytes() const {
+    return journal.size();
+}
+
+// Write the whole catalog to the data file and empty the journal
+bool JournaledStorage::checkpoint(const std::vector<Book>& books, int nextId) {
+    if (!MappedFileStorage::checkpoint(books, nextId)) {
+        return false;
+    }
+    if (journal.isOpen() && !journal.truncate()) {
+        report(true, "Cannot truncate journal for " + filename);
+        return false;
+    }
+    return true;
+}
+
+// Choose how appends wait for the disk
+void JournaledStorage::setDurability(Journal::Durability mode) {
+    journal.setDurability(mode);
+}
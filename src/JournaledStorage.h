@@ -0,0 +1,32 @@
+#ifndef JOURNALED_STORAGE_H
+#define JOURNALED_STORAGE_H
+
+#include "Journal.h"
+#include "MappedFileStorage.h"
+
+// The mapped data file plus a write-ahead journal (filename.journal):
+// every change is appended to the journal as it is made and the data file
+// is only rewritten at checkpoints, which empty the journal. Changes still
+// in the journal at startup are replayed; a journal that cannot be read, or
+// is damaged before its last record, fails open. How soon an append is on
+// disk is set with setDurability.
+class JournaledStorage : public MappedFileStorage {
+private:
+    Journal journal;
+
+public:
+    explicit JournaledStorage(const std::string& filename);
+
+    std::string name() const override { return "journaled"; }
+
+    bool open() override;
+    bool needsRecovery() const override;
+    size_t recover(const std::function<void(Journal::Operation, const Book&)>& apply) override;
+    bool record(Journal::Operation op, const Book& book) override;
+    bool record(Journal::Operation op, int id) override;
+    uint64_t pendingBytes() const override;
+    bool checkpoint(const std::vector<Book>& books, int nextId) override;
+    void setDurability(Journal::Durability mode) override;
+};
+
+#endif // JOURNALED_STORAGE_H
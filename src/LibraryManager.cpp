@@ -1,34 +1,457 @@
 #include "LibraryManager.h"
-#include <iostream>
+#include "CsvFormat.h"
+#include "ISBN.h"
+#include "JournaledStorage.h"
+#include "PostgresStorage.h"
+#include "SortEngine.h"
+#include "StringSearch.h"
 #include <fstream>
 #include <algorithm>
-#include <sstream>
-#include <regex>
-#include <limits>
+#include <iterator>
+
+namespace {
+
+// Smallest share of a scan worth handing to another thread
+const size_t MIN_ROWS_PER_THREAD = 16384;
+
+// Rows formatted per block by exportToCSV before the block is written
+const size_t EXPORT_BLOCK_ROWS = 65536;
+
+// Managers this thread holds a Snapshot of
+thread_local std::vector<const LibraryManager*> heldSnapshots;
+
+// Whether this thread holds a Snapshot of manager
+bool holdsSnapshot(const LibraryManager* manager) {
+    return std::find(heldSnapshots.begin(), heldSnapshots.end(), manager) != heldSnapshots.end();
+}
+
+}  // namespace
+
+// Take a shared lock on the catalog for as long as the snapshot lives
+LibraryManager::Snapshot::Snapshot(const LibraryManager& manager) : manager(manager) {
+    if (!holdsSnapshot(&manager)) {
+        lock = std::shared_lock<std::shared_mutex>(manager.catalogMutex);
+    }
+    heldSnapshots.push_back(&manager);
+}
+
+// Release the snapshot
+LibraryManager::Snapshot::~Snapshot() {
+    heldSnapshots.erase(std::find(heldSnapshots.rbegin(), heldSnapshots.rend(), &manager).base() - 1);
+}
+
+// Lock for one read unless a snapshot already covers it
+LibraryManager::ReadLock::ReadLock(const LibraryManager& manager) {
+    if (!holdsSnapshot(&manager)) {
+        lock = std::shared_lock<std::shared_mutex>(manager.catalogMutex);
+    }
+}
+
+// Constructor for a data file with a journal
+LibraryManager::LibraryManager(const std::string& filename, MessageHandler messageHandler)
+    : LibraryManager(std::make_unique<JournaledStorage>(filename), std::move(messageHandler)) {}
+
+// Constructor for a database-backed catalog
+LibraryManager::LibraryManager(std::shared_ptr<DatabaseManager> database, MessageHandler messageHandler)
+    : LibraryManager(std::make_unique<PostgresStorage>(std::move(database)), std::move(messageHandler)) {}
 
 // Constructor
-LibraryManager::LibraryManager(const std::string& filename) : dataFile(filename), nextId(1) {
-    loadBooksFromFile();
+LibraryManager::LibraryManager(std::unique_ptr<StorageEngine> storage, MessageHandler messageHandler)
+    : messageHandler(std::move(messageHandler)), storage(std::move(storage)), storageOpen(false), stringResource(std::pmr::new_delete_resource()), recordsPending(false), pagePosition(0), pageSlot(0), pageCursorValid(false), catalogLoaded(false), textIndexesBuilt(false),
+      orderIndexesBuilt(false), sortOrder(SortOrder::Catalog), nextId(1), checkpointBytes(4 << 20) {
+    this->storage->setMessageHandler(this->messageHandler);
+    storageOpen = this->storage->open();
+    if (storageOpen) {
+        recover();
+    }
 }
 
 // Destructor
 LibraryManager::~LibraryManager() {
-    saveBooksToFile();
+    writeCheckpoint();
 }
 
-// Generate next available ID
-int LibraryManager::generateNextId() {
-    if (books.empty()) {
-        return 1;
+// Pass a load or save message to the handler, if there is one
+void LibraryManager::report(bool isError, const std::string& message) const {
+    if (messageHandler) {
+        messageHandler(isError, message);
+    }
+}
+
+// Build the catalog rows on first access; an unopened store leaves them empty
+void LibraryManager::ensureLoaded() const {
+    std::call_once(loadedOnce, [this] {
+        if (!storageOpen) {
+            return;
+        }
+        catalogLoaded = true;
+        if (const CatalogFile* file = storage->mappedFile()) {
+            loadMappedBooks(*file);
+        } else if (!loadStoredBooks()) {
+            storageOpen = false;
+            catalogLoaded = false;
+        }
+    });
+}
+
+// Whether the catalog could be opened and read
+bool LibraryManager::isOpen() const {
+    ReadLock lock(*this);
+    ensureLoaded();
+    return storageOpen;
+}
+
+// Build the ISBN and trigram indexes on first use
+void LibraryManager::ensureTextIndexes() const {
+    std::call_once(textIndexesOnce, [this] {
+        ensureLoaded();
+        materializeAll();
+        
+        isbnIndex.reserve(books.size());
+        for (size_t slot = 0; slot < books.size(); ++slot) {
+            const Book& book = books[slot];
+            titleColumn.append(book.getTitle());
+            authorColumn.append(book.getAuthor());
+            if (columns.isDeleted(slot)) {
+                continue;
+            }
+            isbnIndex.emplace(ISBN::normalize(book.getIsbn()), book.getId());
+            titleIndex.add(book.getId(), book.getTitle());
+            authorIndex.add(book.getId(), book.getAuthor());
+        }
+        textIndexesBuilt = true;
+    });
+}
+
+// Build the title, author and year orderings on first use
+void LibraryManager::ensureOrderIndexes() const {
+    std::call_once(orderIndexesOnce, [this] {
+        ensureLoaded();
+        materializeAll();
+        
+        // The three indexes are independent, so they can be filled concurrently
+        std::function<void(size_t)> fill = [this](size_t which) {
+            for (size_t slot = 0; slot < books.size(); ++slot) {
+                if (columns.isDeleted(slot)) {
+                    continue;
+                }
+                const Book& book = books[slot];
+                if (which == 0) {
+                    titleOrder.insert(std::string(book.getTitle()), book.getId());
+                } else if (which == 1) {
+                    authorOrder.insert(book.getAuthor(), book.getId());
+                } else {
+                    yearOrder.insert(book.getYear(), book.getId());
+                }
+            }
+        };
+        if (threadPool) {
+            threadPool->run(3, fill);
+        } else {
+            for (size_t which = 0; which < 3; ++which) {
+                fill(which);
+            }
+        }
+        orderIndexesBuilt = true;
+    });
+}
+
+// Enter book in the ordered indexes, if they have been built
+void LibraryManager::addToOrderIndexes(const Book& book) const {
+    if (!orderIndexesBuilt) {
+        return;
+    }
+    titleOrder.insert(std::string(book.getTitle()), book.getId());
+    authorOrder.insert(book.getAuthor(), book.getId());
+    yearOrder.insert(book.getYear(), book.getId());
+}
+
+// Remove book from the ordered indexes, using its current field values
+void LibraryManager::removeFromOrderIndexes(const Book& book) const {
+    if (!orderIndexesBuilt) {
+        return;
+    }
+    titleOrder.erase(std::string(book.getTitle()), book.getId());
+    authorOrder.erase(book.getAuthor(), book.getId());
+    yearOrder.erase(book.getYear(), book.getId());
+}
+
+// Call visit with the slot of every book, in the selected sort order.
+// Until deleted rows are compacted away, catalog order has to step over
+// them to find the slot at offset.
+void LibraryManager::forEachInOrder(const std::function<void(size_t slot)>& visit, size_t offset,
+                                    size_t limit) const {
+    ensureLoaded();
+    size_t rows = books.size() - columns.deletedCount();
+    if (offset >= rows) {
+        return;
+    }
+    limit = std::min(limit, rows - offset);
+    if (sortOrder == SortOrder::Catalog && columns.deletedCount() == 0) {
+        for (size_t slot = offset; slot < offset + limit; ++slot) {
+            visit(slot);
+        }
+        return;
+    }
+    if (sortOrder == SortOrder::Catalog) {
+        size_t visited = 0;
+        for (size_t slot = slotAtPosition(offset); visited < limit; ++slot) {
+            if (!columns.isDeleted(slot)) {
+                visit(slot);
+                ++visited;
+            }
+        }
+        return;
     }
     
-    int maxId = 0;
-    for (const auto& book : books) {
-        if (book.getId() > maxId) {
-            maxId = book.getId();
+    ensureOrderIndexes();
+    auto visitIds = [this, &visit, offset, limit](const auto& index) {
+        auto entry = index.seek(offset);
+        for (size_t visited = 0; visited < limit; ++visited, ++entry) {
+            visit(idIndex.at(entry->second));
         }
+    };
+    switch (sortOrder) {
+        case SortOrder::Title:
+            visitIds(titleOrder);
+            break;
+        case SortOrder::Author:
+            visitIds(authorOrder);
+            break;
+        case SortOrder::Year:
+            visitIds(yearOrder);
+            break;
+        case SortOrder::Catalog:
+            break;
+    }
+}
+
+// Number of ranges a scan over rows is split into: one per thread, as long
+// as each range stays big enough to pay for the hand-off
+size_t LibraryManager::rangeCount(size_t rows) const {
+    if (!threadPool) {
+        return 1;
+    }
+    return std::max<size_t>(1, std::min<size_t>(threadPool->size(), rows / MIN_ROWS_PER_THREAD));
+}
+
+// Call visit(range, begin, end) for contiguous ranges covering [0, rows),
+// concurrently when a thread pool is set. Range i always covers the rows
+// before range i + 1, so per-range results concatenated in range order are
+// the same as a serial scan's.
+void LibraryManager::forEachRange(size_t rows,
+                                  const std::function<void(size_t range, size_t begin, size_t end)>& visit) const {
+    size_t ranges = rangeCount(rows);
+    if (ranges == 1) {
+        visit(0, 0, rows);
+        return;
+    }
+    threadPool->run(ranges, [rows, ranges, &visit](size_t range) {
+        visit(range, rows * range / ranges, rows * (range + 1) / ranges);
+    });
+}
+
+// Decode the strings of the book in slot if they are still in the data file.
+// Readers holding the shared lock may decode concurrently, so the pending
+// set is only touched under pendingMutex until it has been emptied.
+Book& LibraryManager::materialize(size_t slot) const {
+    Book& book = books[slot];
+    if (recordsPending.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        auto it = pendingRecords.find(book.getId());
+        if (it != pendingRecords.end()) {
+            if (!storage->mappedFile()->readStrings(it->second, book)) {
+                report(true, "Corrupt record for book ID " + std::to_string(book.getId()) + " in " +
+                                 storage->location());
+            }
+            pendingRecords.erase(it);
+        }
+        if (pendingRecords.empty()) {
+            recordsPending.store(false, std::memory_order_release);
+        }
+    }
+    return book;
+}
+
+// Decode every record still pending
+void LibraryManager::materializeAll() const {
+    for (size_t slot = 0; slot < books.size() && recordsPending.load(std::memory_order_acquire); ++slot) {
+        materialize(slot);
+    }
+}
+
+// The book with this ID, decoded, or null. Caller holds a lock.
+Book* LibraryManager::findById(int id) const {
+    ensureLoaded();
+    auto it = idIndex.find(id);
+    if (it != idIndex.end()) {
+        return &materialize(it->second);
+    }
+    return nullptr;
+}
+
+// Re-point the ID index at the current slots
+void LibraryManager::rebuildIdIndex() const {
+    idIndex.clear();
+    idIndex.reserve(books.size());
+    for (size_t slot = 0; slot < books.size(); ++slot) {
+        if (!columns.isDeleted(slot)) {
+            idIndex[books[slot].getId()] = slot;
+        }
+    }
+}
+
+// Slots of every book not deleted, in catalog order
+std::vector<size_t> LibraryManager::liveSlots() const {
+    std::vector<size_t> slots;
+    slots.reserve(books.size() - columns.deletedCount());
+    for (size_t slot = 0; slot < books.size(); ++slot) {
+        if (!columns.isDeleted(slot)) {
+            slots.push_back(slot);
+        }
+    }
+    return slots;
+}
+
+// Add a copy of book as the new last slot of every slot-aligned structure
+void LibraryManager::appendRow(const Book& book) {
+    books.emplace_back(book, stringAllocator());
+    indexLastRow();
+}
+
+// Add book as the new last slot, taking over its strings
+void LibraryManager::appendRow(Book&& book) {
+    books.emplace_back(std::move(book), stringAllocator());
+    indexLastRow();
+}
+
+// Extend the other slot-aligned structures to cover the last book
+void LibraryManager::indexLastRow() {
+    size_t slot = books.size() - 1;
+    const Book& book = books[slot];
+    columns.append(book.getId(), book.getYear(), book.getAvailability(),
+                   StringPool::NOT_FOUND, StringPool::NOT_FOUND);
+    internStrings(slot);
+    countRow(slot, true);
+    if (textIndexesBuilt) {
+        titleColumn.append(book.getTitle());
+        authorColumn.append(book.getAuthor());
+    }
+    addToOrderIndexes(book);
+    idIndex[book.getId()] = slot;
+}
+
+// Point the author and category of the book in slot at their pooled copies
+void LibraryManager::internStrings(size_t slot) {
+    Book& book = books[slot];
+    uint32_t authorId = authorPool.intern(book.getAuthor());
+    uint32_t categoryId = categoryPool.intern(book.getCategory());
+    book.shareAuthor(authorPool.shared(authorId));
+    book.shareCategory(categoryPool.shared(categoryId));
+    columns.setAuthorId(slot, authorId);
+    columns.setCategoryId(slot, categoryId);
+}
+
+// Count (or uncount) the book in slot in the running statistics, using the
+// values in its columns
+void LibraryManager::countRow(size_t slot, bool add) const {
+    if (add) {
+        stats.add(columns.yearAt(slot), columns.availableAt(slot), columns.authorIdAt(slot),
+                  columns.categoryIdAt(slot));
+    } else {
+        stats.remove(columns.yearAt(slot), columns.availableAt(slot), columns.authorIdAt(slot),
+                     columns.categoryIdAt(slot));
+    }
+}
+
+// Remove the book in slot from the catalog. The last slot is popped off;
+// any other is only marked deleted, so no later row moves, and deleted
+// rows are compacted away once they make up a quarter of the catalog.
+// Slot of the live book at position in catalog order, stepping over deleted
+// rows from the start or from where the last page began, whichever is nearer
+size_t LibraryManager::slotAtPosition(size_t position) const {
+    std::lock_guard<std::mutex> lock(pageMutex);
+    size_t slot = 0;
+    size_t at = 0;
+    if (pageCursorValid && (pagePosition <= position || pagePosition - position < position)) {
+        slot = pageSlot;
+        at = pagePosition;
+    } else {
+        while (columns.isDeleted(slot)) {
+            ++slot;
+        }
+    }
+    while (at > position) {
+        --slot;
+        if (!columns.isDeleted(slot)) {
+            --at;
+        }
+    }
+    while (at < position) {
+        ++slot;
+        if (!columns.isDeleted(slot)) {
+            ++at;
+        }
+    }
+    pagePosition = position;
+    pageSlot = slot;
+    pageCursorValid = true;
+    return slot;
+}
+
+void LibraryManager::eraseRow(size_t slot) {
+    int id = books[slot].getId();
+    pageCursorValid = false;
+    countRow(slot, false);
+    removeFromOrderIndexes(books[slot]);
+    pendingRecords.erase(id);
+    idIndex.erase(id);
+    if (slot + 1 < books.size()) {
+        columns.markDeleted(slot);
+        if (columns.deletedCount() * 4 >= books.size()) {
+            compactRows();
+        }
+        return;
+    }
+    books.pop_back();
+    columns.erase(slot);
+    if (textIndexesBuilt) {
+        titleColumn.erase(slot);
+        authorColumn.erase(slot);
+    }
+}
+
+// Drop the rows marked deleted, closing the gaps they leave
+void LibraryManager::compactRows() {
+    if (columns.deletedCount() > 0) {
+        applyOrder(liveSlots());
+    }
+}
+
+// Reorder the catalog so that new slot i holds the book from slot order[i];
+// slots missing from order are dropped
+void LibraryManager::applyOrder(const std::vector<size_t>& order) {
+    pageCursorValid = false;
+    std::vector<Book> reordered;
+    reordered.reserve(books.size());
+    for (size_t slot : order) {
+        reordered.push_back(std::move(books[slot]));
+    }
+    books.swap(reordered);
+    columns.permute(order);
+    if (textIndexesBuilt) {
+        titleColumn.permute(order);
+        authorColumn.permute(order);
+    }
+    rebuildIdIndex();
+}
+
+// Drop the ISBN index entry for isbn if it belongs to the given book
+void LibraryManager::eraseIsbnEntry(std::string_view isbn, int id) {
+    auto it = isbnIndex.find(ISBN::normalize(isbn));
+    if (it != isbnIndex.end() && it->second == id) {
+        isbnIndex.erase(it);
     }
-    return maxId + 1;
 }
 
 // Validate year
@@ -36,376 +459,774 @@ bool LibraryManager::isValidYear(int year) const {
     return year >= 1000 && year <= 2030;
 }
 
-// Validate ISBN (simplified validation)
+// Validate ISBN (format and check digit)
 bool LibraryManager::isValidISBN(const std::string& isbn) const {
-    std::regex isbnPattern(R"(^(?:\d{10}|\d{13}|[\d-]{13,17})$)");
-    return std::regex_match(isbn, isbnPattern);
+    return ISBN::isValid(isbn);
 }
 
-// Load books from binary file
-void LibraryManager::loadBooksFromFile() {
-    std::ifstream file(dataFile, std::ios::binary);
-    if (!file.is_open()) {
-        std::cout << "No existing data file found. Starting with empty library.\n";
-        return;
+// Build catalog rows from the fixed-width fields and dictionaries of the
+// mapped file. Titles and ISBNs stay in the file until the record is first
+// touched.
+void LibraryManager::loadMappedBooks(const CatalogFile& catalogFile) const {
+    nextId = catalogFile.nextId();
+    size_t count = catalogFile.recordCount();
+    books.clear();
+    books.reserve(count);
+    columns.clear();
+    columns.reserve(count);
+    pendingRecords.clear();
+    pendingRecords.reserve(count);
+    
+    // Dictionary IDs in the file are positions, so interning in order keeps them
+    authorPool.clear();
+    for (std::string_view author : catalogFile.authors()) {
+        authorPool.intern(author);
+    }
+    categoryPool.clear();
+    for (std::string_view category : catalogFile.categories()) {
+        categoryPool.intern(category);
     }
     
-    books.clear();
-    while (file.peek() != EOF) {
-        Book book;
-        book.readFromFile(file);
-        if (file.good()) {
-            books.push_back(book);
+    for (size_t record = 0; record < count; ++record) {
+        CatalogFile::IndexEntry entry = catalogFile.entry(record);
+        Book& book = books.emplace_back(stringAllocator());
+        book.setId(entry.id);
+        book.setYear(entry.year);
+        book.setAvailability(entry.available != 0);
+        
+        if (entry.authorId < authorPool.size() && entry.categoryId < categoryPool.size()) {
+            book.shareAuthor(authorPool.shared(entry.authorId));
+            book.shareCategory(categoryPool.shared(entry.categoryId));
+            pendingRecords.emplace(entry.id, record);
+        } else {
+            // A file without dictionaries (an older format that could not
+            // be migrated) keeps every string in the record
+            if (!catalogFile.readStrings(record, book)) {
+                report(true, "Corrupt record for book ID " + std::to_string(entry.id) + " in " +
+                                 storage->location());
+            }
+            entry.authorId = authorPool.intern(book.getAuthor());
+            entry.categoryId = categoryPool.intern(book.getCategory());
+            book.shareAuthor(authorPool.shared(entry.authorId));
+            book.shareCategory(categoryPool.shared(entry.categoryId));
         }
+        columns.append(entry.id, entry.year, entry.available != 0, entry.authorId, entry.categoryId);
     }
+    recordsPending.store(!pendingRecords.empty(), std::memory_order_release);
+    rebuildIdIndex();
     
-    file.close();
-    std::cout << "Loaded " << books.size() << " books from file.\n";
+    stats.clear();
+    for (size_t slot = 0; slot < count; ++slot) {
+        countRow(slot, true);
+    }
 }
 
-// Save books to binary file
-void LibraryManager::saveBooksToFile() {
-    std::ofstream file(dataFile, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Error: Cannot save data to file " << dataFile << std::endl;
+// Build catalog rows from every book the storage engine holds; false if
+// it could not read them
+bool LibraryManager::loadStoredBooks() const {
+    std::vector<Book> stored;
+    if (!storage->load(stored, nextId)) {
+        return false;
+    }
+    books.clear();
+    books.reserve(stored.size());
+    columns.clear();
+    columns.reserve(stored.size());
+    pendingRecords.clear();
+    authorPool.clear();
+    categoryPool.clear();
+    
+    for (Book& book : stored) {
+        Book& row = books.emplace_back(std::move(book), stringAllocator());
+        uint32_t authorId = authorPool.intern(row.getAuthor());
+        uint32_t categoryId = categoryPool.intern(row.getCategory());
+        row.shareAuthor(authorPool.shared(authorId));
+        row.shareCategory(categoryPool.shared(categoryId));
+        columns.append(row.getId(), row.getYear(), row.getAvailability(), authorId, categoryId);
+    }
+    recordsPending.store(false, std::memory_order_release);
+    rebuildIdIndex();
+    
+    stats.clear();
+    for (size_t slot = 0; slot < books.size(); ++slot) {
+        countRow(slot, true);
+    }
+    return true;
+}
+
+// Give a new book its ID: the next free one, or one from the storage
+// engine, which may store the book to get it. False if that failed.
+bool LibraryManager::storeNewBook(Book& book) {
+    return storage->assignId(book, nextId);
+}
+
+// Apply changes left by a session that did not checkpoint
+void LibraryManager::recover() {
+    if (!storage->needsRecovery()) {
         return;
     }
     
-    for (const auto& book : books) {
-        book.writeToFile(file);
+    ensureLoaded();
+    storage->recover([this](Journal::Operation op, const Book& book) { applyJournalEntry(op, book); });
+}
+
+// Redo one journaled operation. Safe to apply twice.
+void LibraryManager::applyJournalEntry(Journal::Operation op, const Book& book) {
+    auto it = idIndex.find(book.getId());
+    switch (op) {
+        case Journal::Operation::Add:
+        case Journal::Operation::Update:
+            if (it != idIndex.end()) {
+                size_t slot = it->second;
+                pendingRecords.erase(book.getId());
+                removeFromOrderIndexes(books[slot]);
+                countRow(slot, false);
+                books[slot] = book;
+                columns.setYear(slot, book.getYear());
+                columns.setAvailable(slot, book.getAvailability());
+                internStrings(slot);
+                countRow(slot, true);
+                addToOrderIndexes(books[slot]);
+            } else {
+                appendRow(book);
+            }
+            nextId = std::max(nextId, book.getId() + 1);
+            break;
+        case Journal::Operation::Delete:
+            if (it != idIndex.end()) {
+                eraseRow(it->second);
+            }
+            break;
+        case Journal::Operation::Borrow:
+        case Journal::Operation::Return:
+            if (it != idIndex.end()) {
+                bool available = op == Journal::Operation::Return;
+                if (columns.availableAt(it->second) != available) {
+                    stats.changeAvailable(available);
+                }
+                books[it->second].setAvailability(available);
+                columns.setAvailable(it->second, available);
+            }
+            break;
+    }
+}
+
+// Record an add or update with the storage engine. Mutations record before
+// they change the catalog, so a change storage did not take is never made.
+bool LibraryManager::logOperation(Journal::Operation op, const Book& book) {
+    return storage->record(op, book);
+}
+
+// Record a delete, borrow or return
+bool LibraryManager::logOperation(Journal::Operation op, int id) {
+    return storage->record(op, id);
+}
+
+// Checkpoint once the storage engine holds enough unsaved changes
+void LibraryManager::checkpointIfDue() {
+    if (storage->pendingBytes() >= checkpointBytes) {
+        writeCheckpoint();
+    }
+}
+
+// Save the whole catalog with the storage engine: rewrite the data file
+// and empty the journal, for the file engines
+Status LibraryManager::checkpoint() {
+    WriteLock lock(catalogMutex);
+    return writeCheckpoint();
+}
+
+// Checkpoint with the write lock already held
+Status LibraryManager::writeCheckpoint() {
+    // Nothing was read, so nothing can have changed
+    if (!catalogLoaded) {
+        return Status::Ok;
     }
     
-    file.close();
+    materializeAll();
+    compactRows();
+    return storage->checkpoint(books, nextId) ? Status::Ok : Status::IoError;
+}
+
+// Choose where catalog strings are allocated
+void LibraryManager::setStringArena(bool enabled) {
+    WriteLock lock(catalogMutex);
+    stringResource = enabled ? static_cast<std::pmr::memory_resource*>(&stringArena)
+                             : std::pmr::new_delete_resource();
+}
+
+// Use threads workers for scans and sorts
+void LibraryManager::setThreadCount(unsigned threads) {
+    WriteLock lock(catalogMutex);
+    if (threads <= 1) {
+        threadPool.reset();
+    } else {
+        threadPool = std::make_unique<ThreadPool>(threads);
+    }
+}
+
+// Number of threads scans and sorts are split across
+unsigned LibraryManager::getThreadCount() const {
+    ReadLock lock(*this);
+    return threadPool ? threadPool->size() : 1;
+}
+
+// Order in which books are currently listed
+LibraryManager::SortOrder LibraryManager::getSortOrder() const {
+    ReadLock lock(*this);
+    return sortOrder;
 }
 
 // Add a new book record
-bool LibraryManager::addRecord(const std::string& title, const std::string& author, 
-                              int year, const std::string& isbn, const std::string& category) {
+Status LibraryManager::addRecord(const std::string& title, const std::string& author, 
+                                int year, const std::string& isbn, const std::string& category, int* newIdOut) {
     // Validate input
     if (title.empty() || author.empty()) {
-        std::cerr << "Error: Title and author cannot be empty.\n";
-        return false;
+        return Status::EmptyField;
     }
     
     if (!isValidYear(year)) {
-        std::cerr << "Error: Invalid year. Must be between 1000 and 2030.\n";
-        return false;
+        return Status::InvalidYear;
     }
     
     if (!isValidISBN(isbn)) {
-        std::cerr << "Error: Invalid ISBN format.\n";
-        return false;
+        return Status::InvalidIsbn;
     }
     
     // Check for duplicate ISBN
-    for (const auto& book : books) {
-        if (book.getIsbn() == isbn) {
-            std::cerr << "Error: A book with this ISBN already exists.\n";
-            return false;
-        }
+    WriteLock lock(catalogMutex);
+    ensureTextIndexes();
+    std::string normalizedIsbn = ISBN::normalize(isbn);
+    if (!storageOpen) {
+        return storage->failureStatus();
     }
-    
-    int newId = generateNextId();
-    Book newBook(newId, title, author, year, isbn, category);
-    books.push_back(newBook);
-    
-    std::cout << "Book added successfully with ID: " << newId << std::endl;
-    return true;
-}
-
-// Display all records
-void LibraryManager::displayAllRecords() const {
-    if (books.empty()) {
-        std::cout << "No books in the library.\n";
-        return;
+    if (isbnIndex.count(normalizedIsbn)) {
+        return Status::DuplicateIsbn;
     }
     
-    std::cout << "\n" << std::string(105, '=') << std::endl;
-    std::cout << "LIBRARY BOOK RECORDS" << std::endl;
-    std::cout << std::string(105, '=') << std::endl;
-    std::cout << std::left << std::setw(5) << "ID" 
-              << std::setw(25) << "Title" 
-              << std::setw(20) << "Author" 
-              << std::setw(6) << "Year" 
-              << std::setw(15) << "ISBN" 
-              << std::setw(15) << "Category" 
-              << std::setw(10) << "Status" 
-              << std::endl;
-    std::cout << std::string(105, '-') << std::endl;
+    Book book(0, title, author, year, isbn, category, true, stringAllocator());
+    int unusedId = nextId;
+    if (!storeNewBook(book)) {
+        return storage->failureStatus();
+    }
+    if (!logOperation(Journal::Operation::Add, book)) {
+        nextId = unusedId;
+        return storage->failureStatus();
+    }
+    int newId = book.getId();
+    appendRow(std::move(book));
+    isbnIndex.emplace(normalizedIsbn, newId);
+    titleIndex.add(newId, title);
+    authorIndex.add(newId, author);
+    checkpointIfDue();
     
-    for (const auto& book : books) {
-        book.displayBook();
+    if (newIdOut) {
+        *newIdOut = newId;
     }
-    std::cout << std::string(105, '=') << std::endl;
-    std::cout << "Total books: " << books.size() << std::endl;
+    return Status::Ok;
+}
+
+// Up to limit books in listing order, starting at position offset
+std::vector<Book*> LibraryManager::listRecords(size_t offset, size_t limit) const {
+    ReadLock lock(*this);
+    std::vector<Book*> results;
+    forEachInOrder([this, &results](size_t slot) { results.push_back(&materialize(slot)); }, offset, limit);
+    return results;
 }
 
 // Search record by ID
 Book* LibraryManager::searchRecordByID(int id) {
-    auto it = std::find_if(books.begin(), books.end(), 
-                          [id](const Book& book) { return book.getId() == id; });
-    
-    if (it != books.end()) {
-        return &(*it);
+    ReadLock lock(*this);
+    return findById(id);
+}
+
+// Search record by ISBN (either ISBN-10 or ISBN-13 form)
+Book* LibraryManager::searchRecordByISBN(const std::string& isbn) {
+    ReadLock lock(*this);
+    ensureTextIndexes();
+    auto it = isbnIndex.find(ISBN::normalize(isbn));
+    if (it != isbnIndex.end()) {
+        return findById(it->second);
     }
     return nullptr;
 }
 
-// Search records by title
-std::vector<Book*> LibraryManager::searchRecordsByTitle(const std::string& title) {
-    std::vector<Book*> results;
-    std::string lowerTitle = title;
-    std::transform(lowerTitle.begin(), lowerTitle.end(), lowerTitle.begin(), ::tolower);
+// Case-insensitive substring search over one text field. Queries of at
+// least three characters are narrowed through the field's trigram index;
+// shorter ones fall back to a full scan. Results keep catalog order.
+std::vector<Book*> LibraryManager::searchByField(const std::string& query, const TrigramIndex& index,
+                                                 const PackedStrings& column) const {
+    std::string lowerQuery = query;
+    std::transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), ::tolower);
     
-    for (auto& book : books) {
-        std::string bookTitle = book.getTitle();
-        std::transform(bookTitle.begin(), bookTitle.end(), bookTitle.begin(), ::tolower);
-        
-        if (bookTitle.find(lowerTitle) != std::string::npos) {
-            results.push_back(&book);
-        }
+    // Matching slots, gathered per range and concatenated in range order
+    std::vector<std::vector<size_t>> matches;
+    bool fullScan = query.size() < TrigramIndex::MIN_QUERY_LENGTH;
+    if (fullScan) {
+        matches.resize(rangeCount(column.size()));
+        forEachRange(column.size(), [&](size_t range, size_t begin, size_t end) {
+            for (size_t slot = begin; slot < end; ++slot) {
+                if (!columns.isDeleted(slot) && StringSearch::containsIgnoreCase(column.at(slot), lowerQuery)) {
+                    matches[range].push_back(slot);
+                }
+            }
+        });
+    } else {
+        std::vector<int> candidates = index.candidates(query);
+        matches.resize(rangeCount(candidates.size()));
+        forEachRange(candidates.size(), [&](size_t range, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                auto it = idIndex.find(candidates[i]);
+                if (it != idIndex.end() && StringSearch::containsIgnoreCase(column.at(it->second), lowerQuery)) {
+                    matches[range].push_back(it->second);
+                }
+            }
+        });
     }
     
+    std::vector<size_t> slots;
+    for (const auto& rangeMatches : matches) {
+        slots.insert(slots.end(), rangeMatches.begin(), rangeMatches.end());
+    }
+    if (!fullScan) {
+        std::sort(slots.begin(), slots.end());
+    }
+    
+    std::vector<Book*> results;
+    results.reserve(slots.size());
+    for (size_t slot : slots) {
+        results.push_back(&books[slot]);
+    }
     return results;
 }
 
+// Search records by title
+std::vector<Book*> LibraryManager::searchRecordsByTitle(const std::string& title) {
+    ReadLock lock(*this);
+    ensureTextIndexes();
+    return searchByField(title, titleIndex, titleColumn);
+}
+
 // Search records by author
 std::vector<Book*> LibraryManager::searchRecordsByAuthor(const std::string& author) {
+    ReadLock lock(*this);
+    ensureTextIndexes();
+    return searchByField(author, authorIndex, authorColumn);
+}
+
+// Books whose dictionary ID in column equals id, in catalog order
+std::vector<Book*> LibraryManager::filterByColumn(const std::vector<uint32_t>& column, uint32_t id) const {
     std::vector<Book*> results;
-    std::string lowerAuthor = author;
-    std::transform(lowerAuthor.begin(), lowerAuthor.end(), lowerAuthor.begin(), ::tolower);
-    
-    for (auto& book : books) {
-        std::string bookAuthor = book.getAuthor();
-        std::transform(bookAuthor.begin(), bookAuthor.end(), bookAuthor.begin(), ::tolower);
-        
-        if (bookAuthor.find(lowerAuthor) != std::string::npos) {
-            results.push_back(&book);
+    if (id == StringPool::NOT_FOUND) {
+        return results;
+    }
+    for (size_t slot = 0; slot < column.size(); ++slot) {
+        if (column[slot] == id && !columns.isDeleted(slot)) {
+            results.push_back(&materialize(slot));
         }
     }
-    
     return results;
 }
 
+// Books by exactly this author
+std::vector<Book*> LibraryManager::filterByAuthor(const std::string& author) {
+    ReadLock lock(*this);
+    ensureLoaded();
+    return filterByColumn(columns.authorIdColumn(), authorPool.find(author));
+}
+
+// Books in exactly this category
+std::vector<Book*> LibraryManager::filterByCategory(const std::string& category) {
+    ReadLock lock(*this);
+    ensureLoaded();
+    return filterByColumn(columns.categoryIdColumn(), categoryPool.find(category));
+}
+
 // Delete record by ID
-bool LibraryManager::deleteRecord(int id) {
-    auto it = std::find_if(books.begin(), books.end(), 
-                          [id](const Book& book) { return book.getId() == id; });
+Status LibraryManager::deleteRecord(int id) {
+    WriteLock lock(catalogMutex);
+    ensureLoaded();
+    auto indexIt = idIndex.find(id);
     
-    if (it != books.end()) {
-        std::cout << "Deleting book: " << it->getTitle() << " by " << it->getAuthor() << std::endl;
-        books.erase(it);
-        std::cout << "Book deleted successfully.\n";
-        return true;
+    if (indexIt != idIndex.end()) {
+        size_t slot = indexIt->second;
+        materialize(slot);
+        if (!logOperation(Journal::Operation::Delete, id)) {
+            return storage->failureStatus();
+        }
+        auto it = books.begin() + slot;
+        if (textIndexesBuilt) {
+            eraseIsbnEntry(it->getIsbn(), id);
+            titleIndex.remove(id, it->getTitle());
+            authorIndex.remove(id, it->getAuthor());
+        }
+        eraseRow(slot);
+        checkpointIfDue();
+        return Status::Ok;
     }
     
-    std::cout << "Book with ID " << id << " not found.\n";
-    return false;
+    return Status::NotFound;
 }
 
-// Update record
-bool LibraryManager::updateRecord(int id) {
-    Book* book = searchRecordByID(id);
+// Change the fields set in update. Every new value is checked before any
+// is applied, so a rejected update leaves the book as it was.
+Status LibraryManager::updateRecord(int id, const BookUpdate& update) {
+    WriteLock lock(catalogMutex);
+    ensureTextIndexes();
+    Book* book = findById(id);
     if (!book) {
-        std::cout << "Book with ID " << id << " not found.\n";
-        return false;
+        return Status::NotFound;
     }
     
-    std::cout << "Current book details:\n";
-    book->displayBook();
-    std::cout << "\nEnter new details (press Enter to keep current value):\n";
-    
-    std::cout << "Current title: " << book->getTitle() << "\nNew title: ";
-    std::string newTitle = getValidatedStringInput("", true);
-    if (!newTitle.empty()) {
-        book->setTitle(newTitle);
+    if ((update.title && update.title->empty()) || (update.author && update.author->empty())) {
+        return Status::EmptyField;
     }
-    
-    std::cout << "Current author: " << book->getAuthor() << "\nNew author: ";
-    std::string newAuthor = getValidatedStringInput("", true);
-    if (!newAuthor.empty()) {
-        book->setAuthor(newAuthor);
+    if (update.year && !isValidYear(*update.year)) {
+        return Status::InvalidYear;
     }
-    
-    std::cout << "Current year: " << book->getYear() << "\nNew year (0 to keep current): ";
-    int newYear = getValidatedIntInput("", 0, 2030);
-    if (newYear > 0 && isValidYear(newYear)) {
-        book->setYear(newYear);
+    std::string normalizedIsbn;
+    if (update.isbn) {
+        if (!isValidISBN(*update.isbn)) {
+            return Status::InvalidIsbn;
+        }
+        normalizedIsbn = ISBN::normalize(*update.isbn);
+        auto existing = isbnIndex.find(normalizedIsbn);
+        if (existing != isbnIndex.end() && existing->second != id) {
+            return Status::DuplicateIsbn;
+        }
     }
     
-    std::cout << "Current ISBN: " << book->getIsbn() << "\nNew ISBN: ";
-    std::string newIsbn = getValidatedStringInput("", true);
-    if (!newIsbn.empty() && isValidISBN(newIsbn)) {
-        book->setIsbn(newIsbn);
+    Book updated(*book);
+    if (update.title) {
+        updated.setTitle(*update.title);
     }
-    
-    std::cout << "Current category: " << book->getCategory() << "\nNew category: ";
-    std::string newCategory = getValidatedStringInput("", true);
-    if (!newCategory.empty()) {
-        book->setCategory(newCategory);
+    if (update.author) {
+        updated.setAuthor(*update.author);
+    }
+    if (update.year) {
+        updated.setYear(*update.year);
+    }
+    if (update.isbn) {
+        updated.setIsbn(*update.isbn);
+    }
+    if (update.category) {
+        updated.setCategory(*update.category);
+    }
+    if (!logOperation(Journal::Operation::Update, updated)) {
+        return storage->failureStatus();
     }
     
-    std::cout << "Book updated successfully.\n";
-    return true;
+    size_t slot = idIndex.at(id);
+    removeFromOrderIndexes(*book);
+    countRow(slot, false);
+    if (update.title) {
+        titleIndex.remove(id, book->getTitle());
+        titleIndex.add(id, *update.title);
+        titleColumn.set(slot, *update.title);
+        book->setTitle(*update.title);
+    }
+    if (update.author) {
+        authorIndex.remove(id, book->getAuthor());
+        authorIndex.add(id, *update.author);
+        authorColumn.set(slot, *update.author);
+        book->setAuthor(*update.author);
+    }
+    if (update.year) {
+        columns.setYear(slot, *update.year);
+        book->setYear(*update.year);
+    }
+    if (update.isbn) {
+        eraseIsbnEntry(book->getIsbn(), id);
+        isbnIndex[normalizedIsbn] = id;
+        book->setIsbn(*update.isbn);
+    }
+    if (update.category) {
+        book->setCategory(*update.category);
+    }
+    if (update.author || update.category) {
+        internStrings(slot);
+    }
+    countRow(slot, true);
+    addToOrderIndexes(*book);
+    checkpointIfDue();
+    return Status::Ok;
 }
 
-// Sort books by title
+// List books by title from now on
 void LibraryManager::sortByTitle() {
-    std::sort(books.begin(), books.end(), 
-              [](const Book& a, const Book& b) { return a.getTitle() < b.getTitle(); });
-    std::cout << "Books sorted by title.\n";
+    WriteLock lock(catalogMutex);
+    ensureOrderIndexes();
+    sortOrder = SortOrder::Title;
 }
 
-// Sort books by author
+// List books by author from now on
 void LibraryManager::sortByAuthor() {
-    std::sort(books.begin(), books.end(), 
-              [](const Book& a, const Book& b) { return a.getAuthor() < b.getAuthor(); });
-    std::cout << "Books sorted by author.\n";
+    WriteLock lock(catalogMutex);
+    ensureOrderIndexes();
+    sortOrder = SortOrder::Author;
 }
 
-// Sort books by year
+// List books by year from now on
 void LibraryManager::sortByYear() {
-    std::sort(books.begin(), books.end(), 
-              [](const Book& a, const Book& b) { return a.getYear() < b.getYear(); });
-    std::cout << "Books sorted by year.\n";
+    WriteLock lock(catalogMutex);
+    ensureOrderIndexes();
+    sortOrder = SortOrder::Year;
 }
 
-// Generic sort function
+// Generic sort function. An arbitrary comparator cannot be kept up to date
+// incrementally, so this reorders the catalog itself and lists books in
+// catalog order again.
 void LibraryManager::sortBy(std::function<bool(const Book&, const Book&)> comparator) {
-    std::sort(books.begin(), books.end(), comparator);
+    WriteLock lock(catalogMutex);
+    ensureLoaded();
+    materializeAll();
+    std::vector<size_t> order = liveSlots();
+    std::function<bool(size_t, size_t)> less = [this, &comparator](size_t a, size_t b) {
+        return comparator(books[a], books[b]);
+    };
+    if (threadPool) {
+        SortEngine::comparisonSort(order, less, *threadPool);
+    } else {
+        std::stable_sort(order.begin(), order.end(), less);
+    }
+    applyOrder(order);
+    sortOrder = SortOrder::Catalog;
 }
 
 // Export to CSV
-bool LibraryManager::exportToCSV(const std::string& filename) const {
-    std::ofstream file(filename);
+Status LibraryManager::exportToCSV(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
     if (!file.is_open()) {
-        std::cerr << "Error: Cannot create CSV file " << filename << std::endl;
-        return false;
+        return Status::IoError;
     }
     
-    // Write header
-    file << "ID,Title,Author,Year,ISBN,Category,Status\n";
+    // Decode everything up front so the formatting threads only read books
+    ReadLock lock(*this);
+    ensureLoaded();
+    materializeAll();
+    // Slots in listing order, unless that is simply every slot in turn
+    bool everySlot = sortOrder == SortOrder::Catalog && columns.deletedCount() == 0;
+    std::vector<size_t> order;
+    if (!everySlot) {
+        order.reserve(books.size());
+        forEachInOrder([&order](size_t slot) { order.push_back(slot); });
+    }
+    size_t totalRows = everySlot ? books.size() : order.size();
     
-    // Write book data
-    for (const auto& book : books) {
-        file << book.toCSV() << "\n";
+    // Format a block of rows at a time, split into one contiguous part per
+    // thread, and write the parts in order with one call each
+    std::vector<std::string> parts(rangeCount(EXPORT_BLOCK_ROWS));
+    parts[0] = CsvFormat::HEADER;
+    parts[0] += '\n';
+    file.write(parts[0].data(), parts[0].size());
+    for (size_t first = 0; first < totalRows; first += EXPORT_BLOCK_ROWS) {
+        size_t rows = std::min(EXPORT_BLOCK_ROWS, totalRows - first);
+        forEachRange(rows, [&](size_t range, size_t begin, size_t end) {
+            std::string& part = parts[range];
+            part.clear();
+            for (size_t row = first + begin; row < first + end; ++row) {
+                CsvFormat::appendBook(part, books[everySlot ? row : order[row]]);
+                part += '\n';
+            }
+        });
+        for (size_t range = 0; range < rangeCount(rows); ++range) {
+            file.write(parts[range].data(), parts[range].size());
+        }
     }
     
     file.close();
-    std::cout << "Data exported to " << filename << " successfully.\n";
-    return true;
-}
-
-// Get number of available books
-int LibraryManager::getAvailableBooks() const {
-    return std::count_if(books.begin(), books.end(), 
-                        [](const Book& book) { return book.getAvailability(); });
-}
-
-// Get number of borrowed books
-int LibraryManager::getBorrowedBooks() const {
-    return books.size() - getAvailableBooks();
+    return file ? Status::Ok : Status::IoError;
 }
 
-// Display library statistics
-void LibraryManager::displayStatistics() const {
-    std::cout << "\n=== LIBRARY STATISTICS ===\n";
-    std::cout << "Total books: " << getTotalBooks() << std::endl;
-    std::cout << "Available books: " << getAvailableBooks() << std::endl;
-    std::cout << "Borrowed books: " << getBorrowedBooks() << std::endl;
-    std::cout << "===========================\n";
-}
-
-// Borrow a book
-bool LibraryManager::borrowBook(int id) {
-    Book* book = searchRecordByID(id);
-    if (!book) {
-        std::cout << "Book with ID " << id << " not found.\n";
+// Add one row read by importFromCSV, applying the same checks as addRecord
+bool LibraryManager::insertImportedRow(CsvImporter::Row& row, std::string& error) {
+    if (row.title.empty() || row.author.empty()) {
+        error = "title and author cannot be empty";
         return false;
     }
-    
-    if (!book->getAvailability()) {
-        std::cout << "Book is already borrowed.\n";
+    if (!isValidYear(row.year)) {
+        error = "year " + std::to_string(row.year) + " is not between 1000 and 2030";
         return false;
     }
     
-    book->setAvailability(false);
-    std::cout << "Book '" << book->getTitle() << "' borrowed successfully.\n";
-    return true;
-}
-
-// Return a book
-bool LibraryManager::returnBook(int id) {
-    Book* book = searchRecordByID(id);
-    if (!book) {
-        std::cout << "Book with ID " << id << " not found.\n";
+    auto isbnEntry = isbnIndex.emplace(std::move(row.normalizedIsbn), 0);
+    if (!isbnEntry.second) {
+        error = "duplicate ISBN " + row.isbn;
         return false;
     }
     
-    if (book->getAvailability()) {
-        std::cout << "Book is already available.\n";
+    Book book(0, row.title, row.author, row.year, row.isbn, row.category, row.available, stringAllocator());
+    if (!storeNewBook(book)) {
+        isbnIndex.erase(isbnEntry.first);
+        error = "the " + storage->name() + " storage engine rejected the row: " + storage->lastError();
         return false;
     }
-    
-    book->setAvailability(true);
-    std::cout << "Book '" << book->getTitle() << "' returned successfully.\n";
+    int newId = book.getId();
+    isbnEntry.first->second = newId;
+    appendRow(std::move(book));
+    titleIndex.add(newId, row.title);
+    authorIndex.add(newId, row.author);
     return true;
 }
 
-// Validate input based on type
-bool LibraryManager::validateInput(const std::string& input, const std::string& type) {
-    if (type == "number") {
-        return !input.empty() && std::all_of(input.begin(), input.end(), ::isdigit);
-    } else if (type == "string") {
-        return !input.empty();
+// Import books from CSV file. Rows are not recorded one by one: the storage
+// engine gets them all at the end (a database stores them in one bulk
+// insert) and a checkpoint follows. Rejected rows do not make the import
+// fail; summary, if given, counts them.
+Status LibraryManager::importFromCSV(const std::string& filename, CsvImporter::Summary* summary) {
+    WriteLock lock(catalogMutex);
+    ensureTextIndexes();
+    if (!storageOpen) {
+        return storage->failureStatus();
     }
-    return true;
-}
-
-// Get validated integer input
-int LibraryManager::getValidatedIntInput(const std::string& prompt, int min, int max) {
-    int value;
-    std::string input;
     
-    while (true) {
-        if (!prompt.empty()) {
-            std::cout << prompt;
-        }
-        
-        std::getline(std::cin, input);
-        
-        if (input.empty() && min == 0) {
-            return 0; // Allow empty input if min is 0
+    CsvImporter importer(threadPool.get());
+    CsvImporter::Summary localSummary;
+    CsvImporter::Summary& result = summary ? *summary : localSummary;
+    size_t firstImported = books.size();
+    int firstImportedId = nextId;
+    storage->beginImport();
+    Status status = importer.import(
+        filename, [this](CsvImporter::Row& row, std::string& error) { return insertImportedRow(row, error); },
+        result);
+    
+    std::vector<const Book*> imported;
+    imported.reserve(books.size() - firstImported);
+    for (size_t slot = firstImported; slot < books.size(); ++slot) {
+        imported.push_back(&books[slot]);
+    }
+    if (!storage->finishImport(imported)) {
+        // Take the rows back out, newest first, and give their IDs back, so
+        // the catalog still matches storage
+        while (books.size() > firstImported) {
+            size_t slot = books.size() - 1;
+            const Book& book = books[slot];
+            eraseIsbnEntry(book.getIsbn(), book.getId());
+            titleIndex.remove(book.getId(), book.getTitle());
+            authorIndex.remove(book.getId(), book.getAuthor());
+            eraseRow(slot);
         }
-        
-        try {
-            value = std::stoi(input);
-            if (value >= min && value <= max) {
-                return value;
-            } else {
-                std::cout << "Please enter a number between " << min << " and " << max << ": ";
-            }
-        } catch (const std::exception& e) {
-            std::cout << "Invalid input. Please enter a valid number: ";
+        nextId = firstImportedId;
+        return storage->failureStatus();
+    }
+    if (status != Status::Ok || imported.empty()) {
+        return status;
+    }
+    return writeCheckpoint();
+}
+
+// Get total number of books
+int LibraryManager::getTotalBooks() const {
+    ReadLock lock(*this);
+    ensureLoaded();
+    return static_cast<int>(stats.totalCount());
+}
+
+// Get number of available books
+int LibraryManager::getAvailableBooks() const {
+    ReadLock lock(*this);
+    ensureLoaded();
+    return stats.availableCount();
+}
+
+// Get number of borrowed books
+int LibraryManager::getBorrowedBooks() const {
+    ReadLock lock(*this);
+    ensureLoaded();
+    return stats.totalCount() - stats.availableCount();
+}
+
+// Name -> count for every pooled value with at least one book. Pooled
+// values are never removed, so ones no book uses any more are skipped.
+std::map<std::string, int> LibraryManager::countsByName(const std::vector<size_t>& counts,
+                                                        const StringPool& pool) const {
+    std::map<std::string, int> result;
+    for (uint32_t id = 0; id < counts.size(); ++id) {
+        if (counts[id] > 0) {
+            result.emplace(pool.at(id), static_cast<int>(counts[id]));
         }
     }
+    return result;
 }
 
-// Get validated string input
-std::string LibraryManager::getValidatedStringInput(const std::string& prompt, bool allowEmpty) {
-    std::string input;
-    
-    while (true) {
-        if (!prompt.empty()) {
-            std::cout << prompt;
+// Get number of books per author
+std::map<std::string, int> LibraryManager::countByAuthor() const {
+    ReadLock lock(*this);
+    ensureLoaded();
+    return countsByName(stats.authorCountColumn(), authorPool);
+}
+
+// Get number of books per category
+std::map<std::string, int> LibraryManager::countByCategory() const {
+    ReadLock lock(*this);
+    ensureLoaded();
+    return countsByName(stats.categoryCountColumn(), categoryPool);
+}
+
+// Get number of books per publication decade
+std::map<int, int> LibraryManager::countByDecade() const {
+    ReadLock lock(*this);
+    ensureLoaded();
+    return std::map<int, int>(stats.decadeCountMap().begin(), stats.decadeCountMap().end());
+}
+
+// All statistics from one consistent view. Borrows and returns may still
+// run meanwhile, so available and borrowed are derived from one reading.
+LibraryManager::Statistics LibraryManager::getStatistics() const {
+    ReadLock lock(*this);
+    ensureLoaded();
+    Statistics result;
+    size_t available = stats.availableCount();
+    result.totalBooks = static_cast<int>(stats.totalCount());
+    result.availableBooks = static_cast<int>(available);
+    result.borrowedBooks = static_cast<int>(stats.totalCount() - available);
+    result.byCategory = countsByName(stats.categoryCountColumn(), categoryPool);
+    result.byAuthor = countsByName(stats.authorCountColumn(), authorPool);
+    result.byDecade.insert(stats.decadeCountMap().begin(), stats.decadeCountMap().end());
+    result.databaseCache = storage->cacheStats();
+    return result;
+}
+
+// Borrow a book
+Status LibraryManager::borrowBook(int id) {
+    return changeAvailability(id, false);
+}
+
+// Return a book
+Status LibraryManager::returnBook(int id) {
+    return changeAvailability(id, true);
+}
+
+// Mark a book borrowed or available. This needs only the shared lock: the
+// availability bitmap's compare-and-swap decides between racing borrowers,
+// and the slot stays claimed until the change is recorded, so changes to
+// one book reach storage in the order they took effect. A change storage
+// did not take is reverted before the slot is released.
+Status LibraryManager::changeAvailability(int id, bool available) {
+    {
+        ReadLock lock(*this);
+        ensureLoaded();
+        auto it = idIndex.find(id);
+        if (it == idIndex.end()) {
+            return Status::NotFound;
         }
-        
-        std::getline(std::cin, input);
-        
-        if (!input.empty() || allowEmpty) {
-            return input;
-        } else {
-            std::cout << "Input cannot be empty. Please try again: ";
+        size_t slot = it->second;
+        if (!columns.claimAvailable(slot, available)) {
+            return available ? Status::AlreadyAvailable : Status::AlreadyBorrowed;
+        }
+        if (!logOperation(available ? Journal::Operation::Return : Journal::Operation::Borrow, id)) {
+            columns.revertAvailable(slot);
+            return storage->failureStatus();
         }
+        books[slot].setAvailability(available);
+        stats.changeAvailable(available);
+        columns.releaseAvailable(slot);
+    }
+    
+    // Checkpointing rewrites the catalog, which needs the lock alone
+    if (storage->pendingBytes() >= checkpointBytes && !holdsSnapshot(this)) {
+        WriteLock lock(catalogMutex);
+        checkpointIfDue();
     }
+    return Status::Ok;
 }
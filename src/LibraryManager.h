@@ -2,62 +2,345 @@
 #define LIBRARY_MANAGER_H
 
 #include "Book.h"
+#include "CatalogColumns.h"
+#include "CatalogFile.h"
+#include "CatalogStats.h"
+#include "CsvImporter.h"
+#include "OrderedIndex.h"
+#include "PackedStrings.h"
+#include "SortEngine.h"
+#include "Status.h"
+#include "StorageEngine.h"
+#include "StringPool.h"
+#include "ThreadPool.h"
+#include "TrigramIndex.h"
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <functional>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <type_traits>
+#include <unordered_map>
 
+// Thread safety: any number of threads may share one LibraryManager.
+// Lookups, searches, listings, statistics, borrows and returns take a
+// shared lock and run side by side; borrows and returns change availability
+// with a compare-and-swap. Adds, deletes, updates, sorts and imports take
+// the lock alone, one at a time. The Book pointers a lookup returns
+// stay valid until the next add, delete, sort or import, so a thread that
+// needs several consistent reads, or keeps pointers while others write,
+// holds a Snapshot around them. The configuration setters are meant to be
+// called before the manager is shared.
 class LibraryManager {
+public:
+    // Order in which listRecords and exportToCSV list books
+    enum class SortOrder { Catalog, Title, Author, Year };
+    
+    // Fields to change in updateRecord; unset fields keep their value
+    struct BookUpdate {
+        std::optional<std::string> title;
+        std::optional<std::string> author;
+        std::optional<int> year;
+        std::optional<std::string> isbn;
+        std::optional<std::string> category;
+    };
+    
+    // Everything the statistics screen shows, read in one go
+    struct Statistics {
+        int totalBooks = 0;
+        int availableBooks = 0;
+        int borrowedBooks = 0;
+        std::map<std::string, int> byCategory;
+        std::map<std::string, int> byAuthor;
+        std::map<int, int> byDecade;  // first year of the decade -> books
+        // Cache activity of the database engine's DatabaseManager. The manager
+        // answers lookups from its own rows, so this only counts callers that
+        // use the DatabaseManager directly.
+        DatabaseManager::CacheStats databaseCache;
+    };
+    
+    // Receives progress and problems found while loading and saving the
+    // catalog. Results of individual operations are returned instead.
+    using MessageHandler = StorageEngine::MessageHandler;
+    
+    // Consistent read view of the catalog. While a Snapshot is alive no
+    // writer can change the catalog, so every read made through the manager
+    // on this thread sees the same books and returned pointers stay valid;
+    // only availability can change, through borrows and returns. Reads on
+    // the owning thread do not lock again. Calling a mutating method other
+    // than borrowBook or returnBook on a thread that holds a Snapshot
+    // deadlocks.
+    class Snapshot {
+    private:
+        const LibraryManager& manager;
+        std::shared_lock<std::shared_mutex> lock;
+        
+    public:
+        explicit Snapshot(const LibraryManager& manager);
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        ~Snapshot();
+    };
+    
 private:
-    std::vector<Book> books;
-    std::string dataFile;
-    int nextId;
+    // Shared lock for one read, skipped if this thread holds a Snapshot
+    class ReadLock {
+    private:
+        std::shared_lock<std::shared_mutex> lock;
+        
+    public:
+        explicit ReadLock(const LibraryManager& manager);
+    };
+    
+    using WriteLock = std::unique_lock<std::shared_mutex>;
+    
+    MessageHandler messageHandler;
+    
+    // Readers share catalogMutex, writers hold it alone. State built lazily
+    // on first use is built once under a once_flag, so readers can trigger
+    // it under the shared lock.
+    mutable std::shared_mutex catalogMutex;
+    mutable std::once_flag loadedOnce;
+    mutable std::once_flag textIndexesOnce;
+    mutable std::once_flag orderIndexesOnce;
+    
+    // Catalog rows are built from the storage engine on first access; from
+    // a mapped data file, their strings are decoded per record on first
+    // touch, hence mutable
+    std::unique_ptr<StorageEngine> storage;
+    mutable bool storageOpen;  // false if storage->open() or load() failed; nothing is then loaded or saved
+    std::pmr::monotonic_buffer_resource stringArena;
+    std::pmr::memory_resource* stringResource;  // stringArena or the heap
+    mutable std::vector<Book> books;
+    mutable CatalogColumns columns;  // fixed-width fields and deleted marks, slot-aligned with books
+    mutable StringPool authorPool;  // distinct authors, IDs stored in columns
+    mutable StringPool categoryPool;  // distinct categories, IDs stored in columns
+    mutable CatalogStats stats;  // totals kept up to date by every mutation
+    mutable std::unordered_map<int, size_t> idIndex;  // book ID -> slot in books
+    mutable std::unordered_map<int, size_t> pendingRecords;  // book ID -> undecoded record in the mapped file
+    mutable std::mutex pendingMutex;  // guards pendingRecords while readers decode records
+    mutable std::atomic<bool> recordsPending;  // false once every record has been decoded
+    
+    // Where the last catalog-order page began while rows are marked deleted,
+    // so the next page need not count live rows from slot 0. Forgotten when
+    // rows are deleted or moved; guarded by pageMutex as readers page at once.
+    mutable size_t pagePosition;
+    mutable size_t pageSlot;
+    mutable bool pageCursorValid;
+    mutable std::mutex pageMutex;
+    mutable bool catalogLoaded;
+    
+    // String indexes and packed text columns, built on first use
+    mutable std::unordered_map<std::string, int> isbnIndex;  // normalized ISBN -> book ID
+    mutable TrigramIndex titleIndex;
+    mutable TrigramIndex authorIndex;
+    mutable PackedStrings titleColumn;
+    mutable PackedStrings authorColumn;
+    mutable bool textIndexesBuilt;
+    
+    // Ordered secondary indexes, built on the first sorted listing and kept
+    // up to date afterwards; sorting only selects which one to list by
+    mutable OrderedIndex<std::string> titleOrder;
+    mutable OrderedIndex<std::string> authorOrder;
+    mutable OrderedIndex<int> yearOrder;
+    mutable bool orderIndexesBuilt;
+    SortOrder sortOrder;
+    
+    // Workers for scans and sorts; null when running single-threaded
+    std::unique_ptr<ThreadPool> threadPool;
+    
+    mutable int nextId;  // read from storage with the catalog
+    
+    // Every mutation is recorded with the storage engine, which is
+    // checkpointed once it holds this many bytes of unsaved changes
+    uint64_t checkpointBytes;
     
     // Private helper methods
-    int generateNextId();
+    void report(bool isError, const std::string& message) const;
+    void ensureLoaded() const;
+    void ensureTextIndexes() const;
+    void ensureOrderIndexes() const;
+    void addToOrderIndexes(const Book& book) const;
+    void removeFromOrderIndexes(const Book& book) const;
+    void forEachInOrder(const std::function<void(size_t slot)>& visit, size_t offset = 0,
+                        size_t limit = SIZE_MAX) const;
+    size_t rangeCount(size_t rows) const;
+    void forEachRange(size_t rows, const std::function<void(size_t range, size_t begin, size_t end)>& visit) const;
+    template <typename KeyFn>
+    void sortPass(std::vector<size_t>& order, KeyFn key) const;
+    template <typename KeyFn, typename... Rest>
+    void sortPasses(std::vector<size_t>& order, KeyFn key, Rest... rest) const;
+    Book& materialize(size_t slot) const;
+    Book* findById(int id) const;
+    void materializeAll() const;
+    void rebuildIdIndex() const;
+    std::vector<size_t> liveSlots() const;
+    Book::allocator_type stringAllocator() const { return Book::allocator_type(stringResource); }
+    void appendRow(const Book& book);
+    void appendRow(Book&& book);
+    void indexLastRow();
+    void internStrings(size_t slot);
+    void countRow(size_t slot, bool add) const;
+    std::vector<Book*> filterByColumn(const std::vector<uint32_t>& column, uint32_t id) const;
+    std::map<std::string, int> countsByName(const std::vector<size_t>& counts, const StringPool& pool) const;
+    size_t slotAtPosition(size_t position) const;
+    void eraseRow(size_t slot);
+    void compactRows();
+    void applyOrder(const std::vector<size_t>& order);
+    void eraseIsbnEntry(std::string_view isbn, int id);
+    std::vector<Book*> searchByField(const std::string& query, const TrigramIndex& index,
+                                     const PackedStrings& column) const;
     bool isValidYear(int year) const;
     bool isValidISBN(const std::string& isbn) const;
-    void loadBooksFromFile();
-    void saveBooksToFile();
+    bool insertImportedRow(CsvImporter::Row& row, std::string& error);
+    void loadMappedBooks(const CatalogFile& file) const;
+    bool loadStoredBooks() const;
+    bool storeNewBook(Book& book);
+    Status writeCheckpoint();
+    void recover();
+    void applyJournalEntry(Journal::Operation op, const Book& book);
+    bool logOperation(Journal::Operation op, const Book& book);
+    bool logOperation(Journal::Operation op, int id);
+    Status changeAvailability(int id, bool available);
+    void checkpointIfDue();
     
 public:
-    // Constructor
-    LibraryManager(const std::string& filename = "library_data.bin");
+    // Constructor. Nothing is printed; messageHandler, if given, is told
+    // about loading, recovery and file errors. The catalog is kept in
+    // filename with a journal beside it (the journaled storage engine).
+    LibraryManager(const std::string& filename = "library_data.bin", MessageHandler messageHandler = nullptr);
+    // Keep the catalog in a PostgreSQL database instead, connecting if
+    // needed. New books get their IDs from the database.
+    explicit LibraryManager(std::shared_ptr<DatabaseManager> database, MessageHandler messageHandler = nullptr);
+    // Keep the catalog wherever storage keeps it
+    explicit LibraryManager(std::unique_ptr<StorageEngine> storage, MessageHandler messageHandler = nullptr);
     
     // Destructor
     ~LibraryManager();
     
+    // Hold the catalog still for a group of reads on this thread
+    Snapshot snapshot() const { return Snapshot(*this); }
+    
     // Core CRUD operations
-    bool addRecord(const std::string& title, const std::string& author, 
-                   int year, const std::string& isbn, const std::string& category);
-    void displayAllRecords() const;
+    Status addRecord(const std::string& title, const std::string& author, 
+                     int year, const std::string& isbn, const std::string& category, int* newId = nullptr);
+    std::vector<Book*> listRecords(size_t offset = 0, size_t limit = SIZE_MAX) const;
     Book* searchRecordByID(int id);
+    Book* searchRecordByISBN(const std::string& isbn);
     std::vector<Book*> searchRecordsByTitle(const std::string& title);
     std::vector<Book*> searchRecordsByAuthor(const std::string& author);
-    bool deleteRecord(int id);
-    bool updateRecord(int id);
+    std::vector<Book*> filterByAuthor(const std::string& author);
+    std::vector<Book*> filterByCategory(const std::string& category);
+    Status deleteRecord(int id);
+    Status updateRecord(int id, const BookUpdate& update);
     
     // Advanced operations
     void sortByTitle();
     void sortByAuthor();
     void sortByYear();
     void sortBy(std::function<bool(const Book&, const Book&)> comparator);
+    template <typename... KeyFns>
+    void sortByKeys(KeyFns... keys);
+    SortOrder getSortOrder() const;
+    
+    // Persistence
+    Status checkpoint();
+    void setCheckpointThreshold(uint64_t journalBytes) { checkpointBytes = journalBytes; }
+    void setDurability(Journal::Durability mode) { storage->setDurability(mode); }
+    const StorageEngine& getStorageEngine() const { return *storage; }
+    // False if the storage engine could not be opened or the catalog could
+    // not be read from it (the reason has been reported); loads the catalog
+    // if it has not been yet. The catalog is then empty and must not be used.
+    bool isOpen() const;
+    // Allocate titles and ISBNs from a monotonic arena instead of one heap
+    // block each. Arena memory is only released with the LibraryManager, so
+    // it suits bulk loads more than long sessions of edits. Applies to rows
+    // built after the call.
+    void setStringArena(bool enabled);
+    
+    // Parallel execution: searches, counts and sorts over large catalogs are
+    // split across this many threads (1, the default, runs them serially).
+    // Results are the same for any thread count.
+    void setThreadCount(unsigned threads);
+    unsigned getThreadCount() const;
     
     // Export/Import operations
-    bool exportToCSV(const std::string& filename) const;
-    bool importFromCSV(const std::string& filename);
+    Status exportToCSV(const std::string& filename) const;
+    Status importFromCSV(const std::string& filename, CsvImporter::Summary* summary = nullptr);
     
-    // Utility methods
-    int getTotalBooks() const { return books.size(); }
+    // Utility methods. Counts are kept up to date as the catalog changes, so
+    // none of these scans it.
+    int getTotalBooks() const;
     int getAvailableBooks() const;
     int getBorrowedBooks() const;
-    void displayStatistics() const;
-    bool borrowBook(int id);
-    bool returnBook(int id);
-    
-    // Input validation helpers
-    static bool validateInput(const std::string& input, const std::string& type);
-    static int getValidatedIntInput(const std::string& prompt, int min = 0, int max = 9999);
-    static std::string getValidatedStringInput(const std::string& prompt, bool allowEmpty = false);
+    std::map<std::string, int> countByAuthor() const;
+    std::map<std::string, int> countByCategory() const;
+    std::map<int, int> countByDecade() const;
+    Statistics getStatistics() const;
+    Status borrowBook(int id);
+    Status returnBook(int id);
 };
 
+// Stable sort of order (catalog slots) by one key extracted from each book
+template <typename KeyFn>
+void LibraryManager::sortPass(std::vector<size_t>& order, KeyFn key) const {
+    using Key = std::decay_t<std::invoke_result_t<KeyFn, const Book&>>;
+    if constexpr (std::is_integral_v<Key>) {
+        static_assert(sizeof(Key) <= sizeof(int32_t), "integer sort keys must fit in 32 bits");
+        std::vector<uint32_t> keys(books.size());
+        for (size_t slot = 0; slot < books.size(); ++slot) {
+            keys[slot] = SortEngine::orderedKey(static_cast<int32_t>(std::invoke(key, books[slot])));
+        }
+        if (threadPool) {
+            SortEngine::radixSort(order, keys, *threadPool);
+        } else {
+            SortEngine::radixSort(order, keys);
+        }
+    } else {
+        static_assert(std::is_convertible_v<Key, std::string_view>, "sort keys must be integers or strings");
+        PackedStrings keys;
+        std::string scratch;
+        for (const auto& book : books) {
+            SortEngine::appendFolded(keys, std::invoke(key, book), scratch);
+        }
+        if (threadPool) {
+            SortEngine::stringSort(order, keys, *threadPool);
+        } else {
+            SortEngine::stringSort(order, keys);
+        }
+    }
+}
+
+// Sort by key and then the remaining keys. Each pass is stable, so sorting
+// by the least significant key first leaves key deciding the final order.
+template <typename KeyFn, typename... Rest>
+void LibraryManager::sortPasses(std::vector<size_t>& order, KeyFn key, Rest... rest) const {
+    if constexpr (sizeof...(Rest) > 0) {
+        sortPasses(order, rest...);
+    }
+    sortPass(order, key);
+}
+
+// Reorder the catalog by one or more keys, most significant first, e.g.
+// sortByKeys(&Book::getAuthor, &Book::getYear). Integer keys are radix
+// sorted and strings compared case-insensitively; books with equal keys
+// keep their relative order. Books are listed in catalog order afterwards.
+template <typename... KeyFns>
+void LibraryManager::sortByKeys(KeyFns... keys) {
+    static_assert(sizeof...(KeyFns) > 0, "sortByKeys needs at least one key");
+    WriteLock lock(catalogMutex);
+    ensureLoaded();
+    materializeAll();
+    std::vector<size_t> order = liveSlots();
+    sortPasses(order, keys...);
+    applyOrder(order);
+    sortOrder = SortOrder::Catalog;
+}
+
 #endif // LIBRARY_MANAGER_H
@@ -0,0 +1,160 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+// Bounded least-recently-used cache, split into shards by key hash so that
+// threads looking up different keys rarely wait for each other. Each shard
+// holds an equal share of the capacity and evicts on its own.
+//
+// Fills are guarded against racing writes with a generation number. A
+// reader notes generation() before fetching a value and passes it to
+// insert, which drops the value if the generation has moved on since:
+// invalidate(key) and invalidateAll() advance it. invalidateAll() also
+// retires every entry already cached, without walking them.
+//
+// All methods are thread-safe.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    struct Counters {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;  // entries dropped to make room
+        size_t entries = 0;
+    };
+
+private:
+    static const size_t SHARDS = 16;
+
+    struct Entry {
+        Key key;
+        Value value;
+        uint64_t generation;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::list<Entry> entries;  // most recently used first
+        std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> positions;
+    };
+
+    std::array<Shard, SHARDS> shards;
+    std::atomic<size_t> shardCapacity;
+    std::atomic<uint64_t> currentGeneration;
+    std::atomic<uint64_t> validFrom;  // entries filled before this generation are stale
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> evictions;
+
+    Shard& shardOf(const Key& key) { return shards[Hash{}(key) % SHARDS]; }
+
+    // Drop the entry at position; caller holds the shard's mutex
+    static void eraseEntry(Shard& shard, typename std::list<Entry>::iterator position) {
+        shard.positions.erase(position->key);
+        shard.entries.erase(position);
+    }
+
+    // Evict least recently used entries beyond capacity; caller holds the shard's mutex
+    void trim(Shard& shard, size_t capacity) {
+        while (shard.entries.size() > capacity) {
+            eraseEntry(shard, std::prev(shard.entries.end()));
+            evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    // Constructor; a capacity of 0 caches nothing
+    explicit LruCache(size_t capacity)
+        : shardCapacity((capacity + SHARDS - 1) / SHARDS), currentGeneration(0), validFrom(0), hits(0),
+          misses(0), evictions(0) {}
+
+    LruCache(const LruCache&) = delete;
+    LruCache& operator=(const LruCache&) = delete;
+
+    // Change the capacity, evicting what no longer fits
+    void setCapacity(size_t capacity) {
+        size_t perShard = (capacity + SHARDS - 1) / SHARDS;
+        shardCapacity.store(perShard);
+        for (Shard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            trim(shard, perShard);
+        }
+    }
+
+    // Generation to pass to insert for a value about to be fetched
+    uint64_t generation() const { return currentGeneration.load(); }
+
+    // Copy the cached value for key into value and mark it recently used
+    bool find(const Key& key, Value& value) {
+        Shard& shard = shardOf(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.positions.find(key);
+        if (it != shard.positions.end() && it->second->generation < validFrom.load()) {
+            eraseEntry(shard, it->second);
+            it = shard.positions.end();
+        }
+        if (it == shard.positions.end()) {
+            misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        value = it->second->value;
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Cache value for key, unless it was fetched before the latest
+    // invalidation (generation is what generation() returned beforehand)
+    void insert(const Key& key, Value value, uint64_t generation) {
+        Shard& shard = shardOf(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        size_t capacity = shardCapacity.load();
+        if (capacity == 0 || generation != currentGeneration.load()) {
+            return;
+        }
+        auto it = shard.positions.find(key);
+        if (it != shard.positions.end()) {
+            eraseEntry(shard, it->second);
+        }
+        shard.entries.push_front(Entry{key, std::move(value), generation});
+        shard.positions.emplace(key, shard.entries.begin());
+        trim(shard, capacity);
+    }
+
+    // Forget key, and any value for it being fetched now
+    void invalidate(const Key& key) {
+        currentGeneration.fetch_add(1);
+        Shard& shard = shardOf(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.positions.find(key);
+        if (it != shard.positions.end()) {
+            eraseEntry(shard, it->second);
+        }
+    }
+
+    // Forget every entry, and any value being fetched now
+    void invalidateAll() { validFrom.store(currentGeneration.fetch_add(1) + 1); }
+
+    Counters counters() {
+        Counters result;
+        result.hits = hits.load(std::memory_order_relaxed);
+        result.misses = misses.load(std::memory_order_relaxed);
+        result.evictions = evictions.load(std::memory_order_relaxed);
+        for (Shard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            result.entries += shard.entries.size();
+        }
+        return result;
+    }
+};
+
+#endif // LRU_CACHE_H
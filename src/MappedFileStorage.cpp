@@ -0,0 +1,66 @@
+#include "MappedFileStorage.h"
+
+// Constructor
+MappedFileStorage::MappedFileStorage(const std::string& filename) : filename(filename) {}
+
+// Map the data file, migrating it from an older format first if needed.
+// Only a missing or empty file starts an empty library: one that cannot be migrated
+// or mapped fails, so nothing is written over it.
+bool MappedFileStorage::open() {
+    if (CatalogFile::needsMigration(filename)) {
+        long migrated = CatalogFile::migrate(filename);
+        if (migrated < 0) {
+            report(true, "Cannot migrate data file " + filename + "; it has been left as it was.");
+            return false;
+        }
+        report(false, "Migrated " + std::to_string(migrated) + " books to data file format v" +
+                          std::to_string(CatalogFile::FORMAT_VERSION) + ".");
+    }
+
+    if (!catalogFile.open(filename)) {
+        if (CatalogFile::isMissingOrEmpty(filename)) {
+            report(false, "No existing data file found. Starting with empty library.");
+            return true;
+        }
+        report(true, "Cannot read data file " + filename +
+                         ": it is damaged, unreadable or from a newer version; it has been left as it was.");
+        return false;
+    }
+    report(false, "Loaded " + std::to_string(catalogFile.recordCount()) + " books from file.");
+    return true;
+}
+
+// Decode every record of the mapped file at once
+bool MappedFileStorage::load(std::vector<Book>& books, int& nextId) {
+    books.clear();
+    nextId = 1;
+    if (!catalogFile.isOpen()) {
+        return true;
+    }
+    books.resize(catalogFile.recordCount());
+    bool intact = true;
+    for (size_t record = 0; record < books.size(); ++record) {
+        if (!catalogFile.readBook(record, books[record])) {
+            report(true, "Corrupt record " + std::to_string(record) + " in " + filename);
+            intact = false;
+        }
+    }
+    nextId = catalogFile.nextId();
+    return intact;
+}
+
+// The mapping, until the first checkpoint replaces the file
+const CatalogFile* MappedFileStorage::mappedFile() const {
+    return catalogFile.isOpen() ? &catalogFile : nullptr;
+}
+
+// Rewrite the data file. The manager has decoded every record, so the old
+// mapping is no longer needed.
+bool MappedFileStorage::checkpoint(const std::vector<Book>& books, int nextId) {
+    if (!CatalogFile::write(filename, books, nextId)) {
+        report(true, "Cannot save data to file " + filename);
+        return false;
+    }
+    catalogFile.close();
+    return true;
+}
@@ -0,0 +1,29 @@
+#ifndef MAPPED_FILE_STORAGE_H
+#define MAPPED_FILE_STORAGE_H
+
+#include "CatalogFile.h"
+#include "StorageEngine.h"
+
+// The catalog in a CatalogFile, mapped read-only when opened so startup
+// costs the same for any size; the manager decodes each record's strings on
+// first touch. Checkpoints (and exit) rewrite the whole file, and changes
+// in between are lost if the process dies. Legacy and older-version files
+// are migrated on open.
+class MappedFileStorage : public StorageEngine {
+protected:
+    std::string filename;
+    CatalogFile catalogFile;
+
+public:
+    explicit MappedFileStorage(const std::string& filename);
+
+    std::string name() const override { return "mmap"; }
+    std::string location() const override { return filename; }
+
+    bool open() override;
+    bool load(std::vector<Book>& books, int& nextId) override;
+    const CatalogFile* mappedFile() const override;
+    bool checkpoint(const std::vector<Book>& books, int nextId) override;
+};
+
+#endif // MAPPED_FILE_STORAGE_H
@@ -0,0 +1,8 @@
+#include "MemoryStorage.h"
+
+// Start with an empty catalog
+bool MemoryStorage::load(std::vector<Book>& books, int& nextId) {
+    books.clear();
+    nextId = 1;
+    return true;
+}
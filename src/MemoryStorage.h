@@ -0,0 +1,17 @@
+#ifndef MEMORY_STORAGE_H
+#define MEMORY_STORAGE_H
+
+#include "StorageEngine.h"
+
+// Keeps nothing: every manager starts with an empty catalog and its changes
+// are gone with it. For tests, benchmarks and scratch sessions.
+class MemoryStorage : public StorageEngine {
+public:
+    std::string name() const override { return "memory"; }
+    std::string location() const override { return "memory"; }
+    bool isPersistent() const override { return false; }
+
+    bool load(std::vector<Book>& books, int& nextId) override;
+};
+
+#endif // MEMORY_STORAGE_H
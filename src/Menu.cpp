@@ -1,10 +1,29 @@
 #include "Menu.h"
+#include "TableRenderer.h"
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <cstdlib>
 
 // Constructor
-Menu::Menu() : libraryManager("library_data.bin") {}
+Menu::Menu() : libraryManager("library_data.bin", printMessage) {}
+
+// Constructor for a catalog kept by a chosen storage engine
+Menu::Menu(std::unique_ptr<StorageEngine> storage) : libraryManager(std::move(storage), printMessage) {}
+
+// Show a load or save message from the library
+void Menu::printMessage(bool isError, const std::string& message) {
+    if (isError) {
+        std::cerr << "Error: " << message << std::endl;
+    } else {
+        std::cout << message << "\n";
+    }
+}
+
+// Show why an operation failed
+void Menu::printStatus(Status status) {
+    std::cerr << "Error: " << statusMessage(status) << std::endl;
+}
 
 // Clear screen (cross-platform)
 void Menu::clearScreen() const {
@@ -39,6 +58,7 @@ void Menu::displayMainMenu() const {
     std::cout << "║  8. Return Book                                              ║\n";
     std::cout << "║  9. Export to CSV                                            ║\n";
     std::cout << "║ 10. Library Statistics                                       ║\n";
+    std::cout << "║ 11. Import from CSV                                          ║\n";
     std::cout << "║  0. Exit                                                     ║\n";
     std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
     std::cout << "Enter your choice: ";
@@ -54,6 +74,7 @@ void Menu::displaySearchMenu() const {
     std::cout << "║  1. Search by ID                      ║\n";
     std::cout << "║  2. Search by Title                   ║\n";
     std::cout << "║  3. Search by Author                  ║\n";
+    std::cout << "║  4. Search by ISBN                    ║\n";
     std::cout << "║  0. Back to Main Menu                 ║\n";
     std::cout << "╚═══════════════════════════════════════╝\n";
     std::cout << "Enter your choice: ";
@@ -74,31 +95,136 @@ void Menu::displaySortMenu() const {
     std::cout << "Enter your choice: ";
 }
 
+// Display all records
+void Menu::displayAllRecords() const {
+    displayRecords(0, SIZE_MAX);
+}
+
+// Display up to limit records in listing order, starting at position offset
+void Menu::displayRecords(size_t offset, size_t limit) const {
+    size_t total = libraryManager.getTotalBooks();
+    if (total == 0) {
+        std::cout << "No books in the library.\n";
+        return;
+    }
+    
+    TableRenderer table(std::cout);
+    table.addLine("");
+    table.addRule('=');
+    table.addLine("LIBRARY BOOK RECORDS");
+    table.addRule('=');
+    table.addHeader();
+    table.addRule('-');
+    
+    std::vector<Book*> books = libraryManager.listRecords(offset, limit);
+    for (const Book* book : books) {
+        table.addRow(*book);
+    }
+    
+    table.addRule('=');
+    if (books.size() == total) {
+        table.addLine("Total books: " + std::to_string(total));
+    } else if (books.empty()) {
+        table.addLine("No books at position " + std::to_string(offset + 1) + "; total books: " +
+                      std::to_string(total));
+    } else {
+        table.addLine("Showing books " + std::to_string(offset + 1) + "-" + std::to_string(offset + books.size()) +
+                      " of " + std::to_string(total));
+    }
+}
+
+// Display library statistics
+void Menu::displayStatistics() const {
+    std::cout << "\n=== LIBRARY STATISTICS ===\n";
+    LibraryManager::Statistics stats = libraryManager.getStatistics();
+    std::cout << "Total books: " << stats.totalBooks << std::endl;
+    std::cout << "Available books: " << stats.availableBooks << std::endl;
+    std::cout << "Borrowed books: " << stats.borrowedBooks << std::endl;
+    
+    if (!stats.byCategory.empty()) {
+        std::cout << "Books by category:\n";
+        for (const auto& entry : stats.byCategory) {
+            std::cout << "  " << (entry.first.empty() ? "(none)" : entry.first) << ": " << entry.second << std::endl;
+        }
+    }
+    if (!stats.byDecade.empty()) {
+        std::cout << "Books by decade:\n";
+        for (const auto& entry : stats.byDecade) {
+            std::cout << "  " << entry.first << "s: " << entry.second << std::endl;
+        }
+    }
+    // The catalog is served from memory, so only lookups made directly on
+    // the DatabaseManager count here; the line is left out until there are any
+    const DatabaseManager::CacheStats& cache = stats.databaseCache;
+    if (cache.hits + cache.misses > 0) {
+        std::cout << "Database cache (direct lookups): " << cache.hits << " hits, " << cache.misses << " misses, "
+                  << cache.evictions << " evictions, " << cache.entries << " entries" << std::endl;
+    }
+    std::cout << "===========================\n";
+}
+
 // Handle add record
 void Menu::handleAddRecord() {
     clearScreen();
     std::cout << "\n=== ADD NEW BOOK ===\n";
     
-    std::string title = LibraryManager::getValidatedStringInput("Enter book title: ");
-    std::string author = LibraryManager::getValidatedStringInput("Enter author name: ");
-    int year = LibraryManager::getValidatedIntInput("Enter publication year: ", 1000, 2030);
-    std::string isbn = LibraryManager::getValidatedStringInput("Enter ISBN: ");
-    std::string category = LibraryManager::getValidatedStringInput("Enter category: ");
+    std::string title = getValidatedStringInput("Enter book title: ");
+    std::string author = getValidatedStringInput("Enter author name: ");
+    int year = getValidatedIntInput("Enter publication year: ", 1000, 2030);
+    std::string isbn = getValidatedStringInput("Enter ISBN: ");
+    std::string category = getValidatedStringInput("Enter category: ");
     
-    if (libraryManager.addRecord(title, author, year, isbn, category)) {
-        std::cout << "Book added successfully!\n";
+    int id = 0;
+    Status status = libraryManager.addRecord(title, author, year, isbn, category, &id);
+    if (status == Status::Ok) {
+        std::cout << "Book added successfully with ID: " << id << "\n";
     } else {
+        printStatus(status);
         std::cout << "Failed to add book. Please check your input.\n";
     }
     
     pauseScreen();
 }
 
-// Handle display all records
+// Handle display all records, one page at a time
 void Menu::handleDisplayAll() {
-    clearScreen();
-    libraryManager.displayAllRecords();
-    pauseScreen();
+    int page = 1;
+    while (true) {
+        clearScreen();
+        int pages = std::max(1, (libraryManager.getTotalBooks() + PAGE_ROWS - 1) / PAGE_ROWS);
+        displayRecords(static_cast<size_t>(page - 1) * PAGE_ROWS, PAGE_ROWS);
+        if (pages == 1) {
+            pauseScreen();
+            return;
+        }
+        
+        std::cout << "Page " << page << " of " << pages
+                  << " - Enter for next page, p for previous, a page number, or 0 to return: ";
+        std::string input;
+        if (!std::getline(std::cin, input)) {
+            return;
+        }
+        if (input.empty()) {
+            if (page == pages) {
+                return;
+            }
+            ++page;
+        } else if (input == "p" || input == "P") {
+            page = std::max(1, page - 1);
+        } else {
+            try {
+                int target = std::stoi(input);
+                if (target == 0) {
+                    return;
+                }
+                if (target >= 1 && target <= pages) {
+                    page = target;
+                }
+            } catch (const std::exception& e) {
+                // Not a number; show the same page again
+            }
+        }
+    }
 }
 
 // Handle search menu
@@ -106,7 +232,7 @@ void Menu::handleSearchMenu() {
     int choice;
     do {
         displaySearchMenu();
-        choice = LibraryManager::getValidatedIntInput("", 0, 3);
+        choice = getValidatedIntInput("", 0, 4);
         
         switch (choice) {
             case 1:
@@ -118,6 +244,9 @@ void Menu::handleSearchMenu() {
             case 3:
                 handleSearchByAuthor();
                 break;
+            case 4:
+                handleSearchByISBN();
+                break;
             case 0:
                 break;
             default:
@@ -132,7 +261,7 @@ void Menu::handleSearchById() {
     clearScreen();
     std::cout << "\n=== SEARCH BY ID ===\n";
     
-    int id = LibraryManager::getValidatedIntInput("Enter book ID: ", 1, 9999);
+    int id = getValidatedIntInput("Enter book ID: ", 1, 9999);
     Book* book = libraryManager.searchRecordByID(id);
     
     if (book) {
@@ -151,7 +280,7 @@ void Menu::handleSearchByTitle() {
     clearScreen();
     std::cout << "\n=== SEARCH BY TITLE ===\n";
     
-    std::string title = LibraryManager::getValidatedStringInput("Enter title (or part of title): ");
+    std::string title = getValidatedStringInput("Enter title (or part of title): ");
     std::vector<Book*> results = libraryManager.searchRecordsByTitle(title);
     
     if (!results.empty()) {
@@ -172,7 +301,7 @@ void Menu::handleSearchByAuthor() {
     clearScreen();
     std::cout << "\n=== SEARCH BY AUTHOR ===\n";
     
-    std::string author = LibraryManager::getValidatedStringInput("Enter author name (or part of name): ");
+    std::string author = getValidatedStringInput("Enter author name (or part of name): ");
     std::vector<Book*> results = libraryManager.searchRecordsByAuthor(author);
     
     if (!results.empty()) {
@@ -188,15 +317,34 @@ void Menu::handleSearchByAuthor() {
     pauseScreen();
 }
 
+// Handle search by ISBN
+void Menu::handleSearchByISBN() {
+    clearScreen();
+    std::cout << "\n=== SEARCH BY ISBN ===\n";
+    
+    std::string isbn = getValidatedStringInput("Enter ISBN (10 or 13 digits): ");
+    Book* book = libraryManager.searchRecordByISBN(isbn);
+    
+    if (book) {
+        std::cout << "\nBook found:\n";
+        std::cout << std::string(50, '-') << std::endl;
+        book->displayBook();
+    } else {
+        std::cout << "No book found with ISBN '" << isbn << "'.\n";
+    }
+    
+    pauseScreen();
+}
+
 // Handle delete record
 void Menu::handleDeleteRecord() {
     clearScreen();
     std::cout << "\n=== DELETE BOOK ===\n";
     
     // First, show current books
-    libraryManager.displayAllRecords();
+    displayAllRecords();
     
-    int id = LibraryManager::getValidatedIntInput("Enter ID of book to delete: ", 1, 9999);
+    int id = getValidatedIntInput("Enter ID of book to delete: ", 1, 9999);
     
     // Confirm deletion
     Book* book = libraryManager.searchRecordByID(id);
@@ -208,8 +356,11 @@ void Menu::handleDeleteRecord() {
         std::getline(std::cin, confirm);
         
         if (confirm == "y" || confirm == "Y") {
-            if (libraryManager.deleteRecord(id)) {
+            Status status = libraryManager.deleteRecord(id);
+            if (status == Status::Ok) {
                 std::cout << "Book deleted successfully!\n";
+            } else {
+                printStatus(status);
             }
         } else {
             std::cout << "Deletion cancelled.\n";
@@ -227,12 +378,57 @@ void Menu::handleUpdateRecord() {
     std::cout << "\n=== UPDATE BOOK ===\n";
     
     // Show current books
-    libraryManager.displayAllRecords();
+    displayAllRecords();
+    
+    int id = getValidatedIntInput("Enter ID of book to update: ", 1, 9999);
+    Book* book = libraryManager.searchRecordByID(id);
+    if (!book) {
+        std::cout << "Book with ID " << id << " not found.\n";
+        pauseScreen();
+        return;
+    }
     
-    int id = LibraryManager::getValidatedIntInput("Enter ID of book to update: ", 1, 9999);
+    std::cout << "Current book details:\n";
+    book->displayBook();
+    std::cout << "\nEnter new details (press Enter to keep current value):\n";
     
-    if (libraryManager.updateRecord(id)) {
+    LibraryManager::BookUpdate update;
+    std::cout << "Current title: " << book->getTitle() << "\nNew title: ";
+    std::string title = getValidatedStringInput("", true);
+    if (!title.empty()) {
+        update.title = title;
+    }
+    
+    std::cout << "Current author: " << book->getAuthor() << "\nNew author: ";
+    std::string author = getValidatedStringInput("", true);
+    if (!author.empty()) {
+        update.author = author;
+    }
+    
+    std::cout << "Current year: " << book->getYear() << "\nNew year (0 to keep current): ";
+    int year = getValidatedIntInput("", 0, 2030);
+    if (year > 0) {
+        update.year = year;
+    }
+    
+    std::cout << "Current ISBN: " << book->getIsbn() << "\nNew ISBN: ";
+    std::string isbn = getValidatedStringInput("", true);
+    if (!isbn.empty()) {
+        update.isbn = isbn;
+    }
+    
+    std::cout << "Current category: " << book->getCategory() << "\nNew category: ";
+    std::string category = getValidatedStringInput("", true);
+    if (!category.empty()) {
+        update.category = category;
+    }
+    
+    Status status = libraryManager.updateRecord(id, update);
+    if (status == Status::Ok) {
         std::cout << "Book updated successfully!\n";
+    } else {
+        printStatus(status);
+        std::cout << "The book was not changed.\n";
     }
     
     pauseScreen();
@@ -243,7 +439,7 @@ void Menu::handleSortMenu() {
     int choice;
     do {
         displaySortMenu();
-        choice = LibraryManager::getValidatedIntInput("", 0, 3);
+        choice = getValidatedIntInput("", 0, 3);
         
         switch (choice) {
             case 1:
@@ -276,10 +472,15 @@ void Menu::handleBorrowBook() {
     std::cout << "\n=== BORROW BOOK ===\n";
     
     // Show available books
-    libraryManager.displayAllRecords();
+    displayAllRecords();
     
-    int id = LibraryManager::getValidatedIntInput("Enter ID of book to borrow: ", 1, 9999);
-    libraryManager.borrowBook(id);
+    int id = getValidatedIntInput("Enter ID of book to borrow: ", 1, 9999);
+    Status status = libraryManager.borrowBook(id);
+    if (status == Status::Ok) {
+        std::cout << "Book '" << libraryManager.searchRecordByID(id)->getTitle() << "' borrowed successfully.\n";
+    } else {
+        printStatus(status);
+    }
     
     pauseScreen();
 }
@@ -290,10 +491,15 @@ void Menu::handleReturnBook() {
     std::cout << "\n=== RETURN BOOK ===\n";
     
     // Show all books
-    libraryManager.displayAllRecords();
+    displayAllRecords();
     
-    int id = LibraryManager::getValidatedIntInput("Enter ID of book to return: ", 1, 9999);
-    libraryManager.returnBook(id);
+    int id = getValidatedIntInput("Enter ID of book to return: ", 1, 9999);
+    Status status = libraryManager.returnBook(id);
+    if (status == Status::Ok) {
+        std::cout << "Book '" << libraryManager.searchRecordByID(id)->getTitle() << "' returned successfully.\n";
+    } else {
+        printStatus(status);
+    }
     
     pauseScreen();
 }
@@ -303,26 +509,59 @@ void Menu::handleExportCSV() {
     clearScreen();
     std::cout << "\n=== EXPORT TO CSV ===\n";
     
-    std::string filename = LibraryManager::getValidatedStringInput("Enter filename (e.g., books.csv): ");
+    std::string filename = getValidatedStringInput("Enter filename (e.g., books.csv): ");
     
     // Add .csv extension if not present
     if (filename.find(".csv") == std::string::npos) {
         filename += ".csv";
     }
     
-    if (libraryManager.exportToCSV(filename)) {
-        std::cout << "Export completed successfully!\n";
+    Status status = libraryManager.exportToCSV(filename);
+    if (status == Status::Ok) {
+        std::cout << "Data exported to " << filename << " successfully.\n";
     } else {
+        printStatus(status);
         std::cout << "Export failed. Please check the filename and try again.\n";
     }
     
     pauseScreen();
 }
 
+// Handle import from CSV
+void Menu::handleImportCSV() {
+    clearScreen();
+    std::cout << "\n=== IMPORT FROM CSV ===\n";
+    std::cout << "The first line must name the columns: Title, Author, Year and ISBN are required,\n";
+    std::cout << "Category and Status are optional.\n";
+    
+    std::string filename = getValidatedStringInput("Enter filename (e.g., books.csv): ");
+    
+    CsvImporter::Summary summary;
+    Status status = libraryManager.importFromCSV(filename, &summary);
+    for (const std::string& error : summary.errors) {
+        std::cerr << "Error: " << error << std::endl;
+    }
+    if (summary.rowsRejected > summary.errors.size()) {
+        std::cerr << "... and " << summary.rowsRejected - summary.errors.size() << " more rejected rows\n";
+    }
+    
+    if (status == Status::Ok) {
+        long rate = summary.seconds > 0 ? static_cast<long>(summary.rowsRead / summary.seconds) : 0;
+        std::cout << "Imported " << summary.rowsImported << " of " << summary.rowsRead << " rows in "
+                  << static_cast<long>(summary.seconds * 1000) << " ms (" << rate << " rows/sec); "
+                  << summary.rowsRejected << " rejected.\n";
+    } else {
+        printStatus(status);
+        std::cout << "Import failed. Please check the file and try again.\n";
+    }
+    
+    pauseScreen();
+}
+
 // Handle statistics
 void Menu::handleStatistics() {
     clearScreen();
-    libraryManager.displayStatistics();
+    displayStatistics();
     pauseScreen();
 }
 
@@ -330,13 +569,18 @@ void Menu::handleStatistics() {
 void Menu::run() {
     int choice;
     
+    if (!libraryManager.isOpen()) {
+        std::cerr << "Error: Cannot open " << libraryManager.getStorageEngine().location() << std::endl;
+        return;
+    }
+    
     std::cout << "Welcome to Library Management System!\n";
     std::cout << "Loading existing data...\n";
     pauseScreen();
     
     do {
         displayMainMenu();
-        choice = LibraryManager::getValidatedIntInput("", 0, 10);
+        choice = getValidatedIntInput("", 0, 11);
         
         switch (choice) {
             case 1:
@@ -369,6 +613,9 @@ void Menu::run() {
             case 10:
                 handleStatistics();
                 break;
+            case 11:
+                handleImportCSV();
+                break;
             case 0:
                 clearScreen();
                 std::cout << "Thank you for using Library Management System!\n";
@@ -380,3 +627,61 @@ void Menu::run() {
         }
     } while (choice != 0);
 }
+
+// Validate input based on type
+bool Menu::validateInput(const std::string& input, const std::string& type) {
+    if (type == "number") {
+        return !input.empty() && std::all_of(input.begin(), input.end(), ::isdigit);
+    } else if (type == "string") {
+        return !input.empty();
+    }
+    return true;
+}
+
+// Get validated integer input
+int Menu::getValidatedIntInput(const std::string& prompt, int min, int max) {
+    int value;
+    std::string input;
+    
+    while (true) {
+        if (!prompt.empty()) {
+            std::cout << prompt;
+        }
+        
+        std::getline(std::cin, input);
+        
+        if (input.empty() && min == 0) {
+            return 0; // Allow empty input if min is 0
+        }
+        
+        try {
+            value = std::stoi(input);
+            if (value >= min && value <= max) {
+                return value;
+            } else {
+                std::cout << "Please enter a number between " << min << " and " << max << ": ";
+            }
+        } catch (const std::exception& e) {
+            std::cout << "Invalid input. Please enter a valid number: ";
+        }
+    }
+}
+
+// Get validated string input
+std::string Menu::getValidatedStringInput(const std::string& prompt, bool allowEmpty) {
+    std::string input;
+    
+    while (true) {
+        if (!prompt.empty()) {
+            std::cout << prompt;
+        }
+        
+        std::getline(std::cin, input);
+        
+        if (!input.empty() || allowEmpty) {
+            return input;
+        } else {
+            std::cout << "Input cannot be empty. Please try again: ";
+        }
+    }
+}
@@ -7,10 +7,18 @@ class Menu {
 private:
     LibraryManager libraryManager;
     
+    // Books per page when listing the catalog
+    static const int PAGE_ROWS = 20;
+    
     // Menu display methods
     void displayMainMenu() const;
     void displaySearchMenu() const;
     void displaySortMenu() const;
+    void displayAllRecords() const;
+    void displayRecords(size_t offset, size_t limit) const;
+    void displayStatistics() const;
+    static void printMessage(bool isError, const std::string& message);
+    static void printStatus(Status status);
     
     // Menu action methods
     void handleAddRecord();
@@ -19,22 +27,35 @@ private:
     void handleSearchById();
     void handleSearchByTitle();
     void handleSearchByAuthor();
+    void handleSearchByISBN();
     void handleDeleteRecord();
     void handleUpdateRecord();
     void handleSortMenu();
     void handleBorrowBook();
     void handleReturnBook();
     void handleExportCSV();
+    void handleImportCSV();
     void handleStatistics();
     
     // Utility methods
     void clearScreen() const;
     void pauseScreen() const;
     
+    // Input validation helpers
+    static bool validateInput(const std::string& input, const std::string& type);
+    static int getValidatedIntInput(const std::string& prompt, int min = 0, int max = 9999);
+    static std::string getValidatedStringInput(const std::string& prompt, bool allowEmpty = false);
+    
 public:
-    // Constructor
+    // Constructors: the catalog in library_data.bin, or wherever storage keeps it
     Menu();
+    explicit Menu(std::unique_ptr<StorageEngine> storage);
+    
+    // Whether the catalog's storage opened; run() does nothing otherwise
+    bool isReady() const { return libraryManager.isOpen(); }
     
     // Main menu loop
     void run();
 };
+
+#endif // MENU_H
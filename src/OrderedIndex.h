@@ -0,0 +1,66 @@
+#ifndef ORDERED_INDEX_H
+#define ORDERED_INDEX_H
+
+#include <cstddef>
+#include <iterator>
+#include <mutex>
+#include <set>
+#include <utility>
+
+// Book IDs kept ordered by a key (title, author, year). Ties are ordered by
+// ID, which is also the order books were added in. Entries are updated one
+// at a time as books change, so reading the order never needs a sort.
+template <typename Key>
+class OrderedIndex {
+private:
+    std::set<std::pair<Key, int>> entries;
+    
+    // Position of the last seek, so paging walks on from the previous page
+    // instead of from the start. Readers seek concurrently, hence the mutex;
+    // any change to the entries forgets it.
+    mutable std::mutex cursorMutex;
+    mutable typename std::set<std::pair<Key, int>>::const_iterator cursor;
+    mutable size_t cursorPosition = 0;
+    mutable bool cursorValid = false;
+
+public:
+    using const_iterator = typename std::set<std::pair<Key, int>>::const_iterator;
+
+    void insert(const Key& key, int id) {
+        entries.emplace(key, id);
+        cursorValid = false;
+    }
+    void erase(const Key& key, int id) {
+        entries.erase(std::make_pair(key, id));
+        cursorValid = false;
+    }
+    void clear() {
+        entries.clear();
+        cursorValid = false;
+    }
+    size_t size() const { return entries.size(); }
+
+    // (key, book ID) pairs in order
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+
+    // Entry at position (below size()) in the order, walked to from the
+    // nearest of the start, the end and the last position sought
+    const_iterator seek(size_t position) const {
+        std::lock_guard<std::mutex> lock(cursorMutex);
+        size_t fromEnd = entries.size() - position;
+        size_t fromCursor = position > cursorPosition ? position - cursorPosition : cursorPosition - position;
+        if (cursorValid && fromCursor <= position && fromCursor <= fromEnd) {
+            std::advance(cursor, static_cast<std::ptrdiff_t>(position) - static_cast<std::ptrdiff_t>(cursorPosition));
+        } else if (position <= fromEnd) {
+            cursor = std::next(entries.begin(), position);
+        } else {
+            cursor = std::prev(entries.end(), fromEnd);
+        }
+        cursorPosition = position;
+        cursorValid = true;
+        return cursor;
+    }
+};
+
+#endif // ORDERED_INDEX_H
@@ -0,0 +1,78 @@
+#include "PackedStrings.h"
+
+// Constructor
+PackedStrings::PackedStrings() : garbage(0) {}
+
+// Remove all values
+void PackedStrings::clear() {
+    bytes.clear();
+    offsets.clear();
+    lengths.clear();
+    garbage = 0;
+}
+
+// Reserve room for count values totalling totalBytes
+void PackedStrings::reserve(size_t count, size_t totalBytes) {
+    offsets.reserve(count);
+    lengths.reserve(count);
+    bytes.reserve(totalBytes);
+}
+
+// Add a value for a new last slot
+void PackedStrings::append(std::string_view value) {
+    offsets.push_back(static_cast<uint32_t>(bytes.size()));
+    lengths.push_back(static_cast<uint32_t>(value.size()));
+    bytes.insert(bytes.end(), value.begin(), value.end());
+}
+
+// Replace the value in slot
+void PackedStrings::set(size_t slot, std::string_view value) {
+    garbage += lengths[slot];
+    offsets[slot] = static_cast<uint32_t>(bytes.size());
+    lengths[slot] = static_cast<uint32_t>(value.size());
+    bytes.insert(bytes.end(), value.begin(), value.end());
+    compactIfWasteful();
+}
+
+// Remove the value in slot, shifting later slots down
+void PackedStrings::erase(size_t slot) {
+    garbage += lengths[slot];
+    offsets.erase(offsets.begin() + slot);
+    lengths.erase(lengths.begin() + slot);
+    compactIfWasteful();
+}
+
+// Rewrite the buffer in the given slot order. This also drops garbage and
+// puts the bytes in scan order again.
+void PackedStrings::permute(const std::vector<size_t>& order) {
+    std::vector<char> packed;
+    packed.reserve(bytes.size() - garbage);
+    std::vector<uint32_t> newOffsets;
+    std::vector<uint32_t> newLengths;
+    newOffsets.reserve(order.size());
+    newLengths.reserve(order.size());
+    
+    for (size_t slot : order) {
+        newOffsets.push_back(static_cast<uint32_t>(packed.size()));
+        newLengths.push_back(lengths[slot]);
+        packed.insert(packed.end(), bytes.begin() + offsets[slot],
+                      bytes.begin() + offsets[slot] + lengths[slot]);
+    }
+    
+    bytes.swap(packed);
+    offsets.swap(newOffsets);
+    lengths.swap(newLengths);
+    garbage = 0;
+}
+
+// Compact once more than half of the buffer is unreachable
+void PackedStrings::compactIfWasteful() {
+    if (garbage * 2 <= bytes.size()) {
+        return;
+    }
+    std::vector<size_t> identity(offsets.size());
+    for (size_t slot = 0; slot < identity.size(); ++slot) {
+        identity[slot] = slot;
+    }
+    permute(identity);
+}
@@ -0,0 +1,40 @@
+#ifndef PACKED_STRINGS_H
+#define PACKED_STRINGS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// A column of strings packed back to back in one byte buffer, addressed by
+// slot. Replacing a value appends the new bytes and leaves the old ones as
+// garbage until the buffer is compacted.
+class PackedStrings {
+private:
+    std::vector<char> bytes;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> lengths;
+    size_t garbage;
+    
+    void compactIfWasteful();
+    
+public:
+    // Constructor
+    PackedStrings();
+    
+    size_t size() const { return offsets.size(); }
+    void clear();
+    void reserve(size_t count, size_t totalBytes);
+    
+    void append(std::string_view value);
+    void set(size_t slot, std::string_view value);
+    void erase(size_t slot);
+    // Reorder so that new slot i holds what was in slot order[i]
+    void permute(const std::vector<size_t>& order);
+    
+    std::string_view at(size_t slot) const {
+        return std::string_view(bytes.data() + offsets[slot], lengths[slot]);
+    }
+};
+
+#endif // PACKED_STRINGS_H
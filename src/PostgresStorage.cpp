@@ -0,0 +1,102 @@
+#include "PostgresStorage.h"
+#include <algorithm>
+
+// Constructor
+PostgresStorage::PostgresStorage(std::shared_ptr<DatabaseManager> database)
+    : database(std::move(database)), importing(false) {}
+
+// Pass the database's last error to the handler
+void PostgresStorage::reportDatabaseError() const {
+    report(true, "Database: " + database->getLastError());
+}
+
+// Connect if needed
+bool PostgresStorage::open() {
+    if (!database->isConnectionActive() && !database->connect()) {
+        reportDatabaseError();
+        return false;
+    }
+    return true;
+}
+
+// Every book in the database. IDs come from the database, so nextId is unused.
+bool PostgresStorage::load(std::vector<Book>& books, int& nextId) {
+    nextId = 1;
+    if (!database->getAllBooks(books)) {
+        reportDatabaseError();
+        return false;
+    }
+    report(false, "Loaded " + std::to_string(books.size()) + " books from database.");
+    return true;
+}
+
+// Store the book and take the ID the database gave it. During an import the
+// ID is reserved instead and the book stored later with the rest.
+bool PostgresStorage::assignId(Book& book, int&) {
+    if (importing) {
+        if (reservedIds.empty()) {
+            reservedIds = database->reserveIds(IMPORT_ID_BLOCK);
+            if (reservedIds.empty()) {
+                reportDatabaseError();
+                return false;
+            }
+            std::reverse(reservedIds.begin(), reservedIds.end());
+        }
+        book.setId(reservedIds.back());
+        reservedIds.pop_back();
+        return true;
+    }
+    int newId = 0;
+    if (!database->insertBook(book, &newId)) {
+        reportDatabaseError();
+        return false;
+    }
+    book.setId(newId);
+    return true;
+}
+
+// Write an update through; adds were stored by assignId
+bool PostgresStorage::record(Journal::Operation op, const Book& book) {
+    if (op == Journal::Operation::Update && !database->updateBook(book)) {
+        reportDatabaseError();
+        return false;
+    }
+    return true;
+}
+
+// Write a delete, borrow or return through
+bool PostgresStorage::record(Journal::Operation op, int id) {
+    bool stored = op == Journal::Operation::Delete ? database->deleteBook(id)
+                                                   : database->setAvailability(id, op == Journal::Operation::Return);
+    if (!stored) {
+        reportDatabaseError();
+    }
+    return stored;
+}
+
+// Reserve IDs for imported books instead of storing them one by one
+void PostgresStorage::beginImport() {
+    importing = true;
+}
+
+// Store every imported book in one bulk insert
+bool PostgresStorage::finishImport(const std::vector<const Book*>& imported) {
+    importing = false;
+    reservedIds.clear();
+    if (!imported.empty() && !database->insertBooks(imported)) {
+        reportDatabaseError();
+        return false;
+    }
+    return true;
+}
+
+// Activity of the database manager's caches. The catalog is loaded with
+// getAllBooks, so only lookups made directly on the database manager count.
+DatabaseManager::CacheStats PostgresStorage::cacheStats() const {
+    return database->getCacheStats();
+}
+
+// The database's last error
+std::string PostgresStorage::lastError() const {
+    return database->getLastError();
+}
@@ -0,0 +1,43 @@
+#ifndef POSTGRES_STORAGE_H
+#define POSTGRES_STORAGE_H
+
+#include "DatabaseManager.h"
+#include "StorageEngine.h"
+#include <memory>
+
+// The catalog in a PostgreSQL database: loaded with one query and every
+// change written through as it is made, so there is nothing to checkpoint.
+// New books are stored as they are added, to get their IDs from the
+// database; an import reserves IDs in blocks and stores its books in one
+// bulk insert at the end.
+class PostgresStorage : public StorageEngine {
+private:
+    std::shared_ptr<DatabaseManager> database;
+    std::vector<int> reservedIds;  // taken from the database for the import in progress
+    bool importing;
+
+    void reportDatabaseError() const;
+
+public:
+    // IDs taken from the database at a time while importing
+    static const size_t IMPORT_ID_BLOCK = 4096;
+
+    explicit PostgresStorage(std::shared_ptr<DatabaseManager> database);
+
+    std::string name() const override { return "postgres"; }
+    std::string location() const override { return "database"; }
+
+    // Connects, unless the database manager already is
+    bool open() override;
+    bool load(std::vector<Book>& books, int& nextId) override;
+    bool assignId(Book& book, int& nextId) override;
+    bool record(Journal::Operation op, const Book& book) override;
+    bool record(Journal::Operation op, int id) override;
+    Status failureStatus() const override { return Status::DatabaseError; }
+    void beginImport() override;
+    bool finishImport(const std::vector<const Book*>& imported) override;
+    DatabaseManager::CacheStats cacheStats() const override;
+    std::string lastError() const override;
+};
+
+#endif // POSTGRES_STORAGE_H
@@ -0,0 +1,217 @@
+#include "SortEngine.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <string>
+#include <utility>
+
+namespace {
+
+const size_t INSERTION_SORT_THRESHOLD = 16;
+
+// Below this many elements per thread a parallel sort is not worth the merges
+const size_t MIN_PARALLEL_RANGE = 8192;
+
+// One element being string-sorted. The key bytes are cached so the hot
+// loop does not go through PackedStrings, and rank (the element's position
+// before sorting) breaks ties to keep the sort stable.
+struct Item {
+    const char* data;
+    uint32_t length;
+    uint32_t rank;
+    size_t element;
+};
+
+// Byte at depth, or -1 past the end so shorter keys sort first
+inline int byteAt(const Item& item, size_t depth) {
+    return depth < item.length ? static_cast<unsigned char>(item.data[depth]) : -1;
+}
+
+// Compare the keys from depth on, then the ranks
+bool lessFrom(const Item& a, const Item& b, size_t depth) {
+    std::string_view left(a.data + depth, a.length - depth);
+    std::string_view right(b.data + depth, b.length - depth);
+    int cmp = left.compare(right);
+    return cmp != 0 ? cmp < 0 : a.rank < b.rank;
+}
+
+void insertionSort(Item* items, size_t count, size_t depth) {
+    for (size_t i = 1; i < count; ++i) {
+        Item current = items[i];
+        size_t j = i;
+        while (j > 0 && lessFrom(current, items[j - 1], depth)) {
+            items[j] = items[j - 1];
+            --j;
+        }
+        items[j] = current;
+    }
+}
+
+int medianOfThree(int a, int b, int c) {
+    if (a < b) {
+        return b < c ? b : (a < c ? c : a);
+    }
+    return a < c ? a : (b < c ? c : b);
+}
+
+// Bentley-Sedgewick multikey quicksort of items, whose keys agree on the
+// first depth bytes
+void multikeySort(Item* items, size_t count, size_t depth) {
+    while (count > 1) {
+        if (count < INSERTION_SORT_THRESHOLD) {
+            insertionSort(items, count, depth);
+            return;
+        }
+        
+        int pivot = medianOfThree(byteAt(items[0], depth), byteAt(items[count / 2], depth),
+                                  byteAt(items[count - 1], depth));
+        
+        // Three-way partition: [0, lt) < pivot, [lt, gt) == pivot, [gt, count) > pivot
+        size_t lt = 0;
+        size_t i = 0;
+        size_t gt = count;
+        while (i < gt) {
+            int value = byteAt(items[i], depth);
+            if (value < pivot) {
+                std::swap(items[lt++], items[i++]);
+            } else if (value > pivot) {
+                std::swap(items[i], items[--gt]);
+            } else {
+                ++i;
+            }
+        }
+        
+        multikeySort(items, lt, depth);
+        multikeySort(items + gt, count - gt, depth);
+        
+        items += lt;
+        count = gt - lt;
+        if (pivot < 0) {
+            // Every key in the middle ended here, so they are equal
+            std::sort(items, items + count, [](const Item& a, const Item& b) { return a.rank < b.rank; });
+            return;
+        }
+        ++depth;
+    }
+}
+    
+// Sort ranges of order concurrently with sortRange, then merge them
+template <typename SortRange, typename Less>
+void sortAndMerge(std::vector<size_t>& order, ThreadPool& pool, SortRange sortRange, Less less) {
+    size_t ranges = std::min<size_t>(pool.size(), order.size() / MIN_PARALLEL_RANGE);
+    if (ranges <= 1) {
+        sortRange(order);
+        return;
+    }
+    
+    std::vector<std::vector<size_t>> parts(ranges);
+    pool.run(ranges, [&](size_t range) {
+        parts[range].assign(order.begin() + order.size() * range / ranges,
+                            order.begin() + order.size() * (range + 1) / ranges);
+        sortRange(parts[range]);
+    });
+    
+    // Merge neighbours until one range is left. std::merge is stable, so
+    // equal elements keep the order of the ranges they came from.
+    while (parts.size() > 1) {
+        std::vector<std::vector<size_t>> merged((parts.size() + 1) / 2);
+        pool.run(parts.size() / 2, [&](size_t pair) {
+            const std::vector<size_t>& left = parts[2 * pair];
+            const std::vector<size_t>& right = parts[2 * pair + 1];
+            merged[pair].resize(left.size() + right.size());
+            std::merge(left.begin(), left.end(), right.begin(), right.end(), merged[pair].begin(), less);
+        });
+        if (parts.size() % 2 != 0) {
+            merged.back() = std::move(parts.back());
+        }
+        parts.swap(merged);
+    }
+    order.swap(parts.front());
+}
+
+}  // namespace
+
+// Identity permutation
+std::vector<size_t> SortEngine::identity(size_t count) {
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = i;
+    }
+    return order;
+}
+
+// Case-fold value into the next key
+void SortEngine::appendFolded(PackedStrings& keys, std::string_view value, std::string& scratch) {
+    scratch.assign(value.data(), value.size());
+    for (char& c : scratch) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    keys.append(scratch);
+}
+
+// Stable LSD radix sort on 32-bit keys
+void SortEngine::radixSort(std::vector<size_t>& order, const std::vector<uint32_t>& keys) {
+    std::vector<size_t> scratch(order.size());
+    for (int shift = 0; shift < 32; shift += 8) {
+        std::array<size_t, 257> offsets = {};
+        for (size_t element : order) {
+            ++offsets[((keys[element] >> shift) & 0xFF) + 1];
+        }
+        // All keys share this byte: the pass would not move anything
+        bool skip = false;
+        for (size_t bucket = 1; bucket <= 256; ++bucket) {
+            if (offsets[bucket] == order.size()) {
+                skip = true;
+                break;
+            }
+        }
+        if (skip) {
+            continue;
+        }
+        
+        for (size_t bucket = 1; bucket <= 256; ++bucket) {
+            offsets[bucket] += offsets[bucket - 1];
+        }
+        for (size_t element : order) {
+            scratch[offsets[(keys[element] >> shift) & 0xFF]++] = element;
+        }
+        order.swap(scratch);
+    }
+}
+
+// Stable multikey quicksort on string keys
+void SortEngine::stringSort(std::vector<size_t>& order, const PackedStrings& keys) {
+    std::vector<Item> items(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        std::string_view key = keys.at(order[i]);
+        items[i] = Item{key.data(), static_cast<uint32_t>(key.size()), static_cast<uint32_t>(i), order[i]};
+    }
+    
+    multikeySort(items.data(), items.size(), 0);
+    
+    for (size_t i = 0; i < items.size(); ++i) {
+        order[i] = items[i].element;
+    }
+}
+
+// Parallel radix sort
+void SortEngine::radixSort(std::vector<size_t>& order, const std::vector<uint32_t>& keys, ThreadPool& pool) {
+    sortAndMerge(order, pool,
+                 [&keys](std::vector<size_t>& range) { radixSort(range, keys); },
+                 [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+}
+
+// Parallel multikey quicksort
+void SortEngine::stringSort(std::vector<size_t>& order, const PackedStrings& keys, ThreadPool& pool) {
+    sortAndMerge(order, pool,
+                 [&keys](std::vector<size_t>& range) { stringSort(range, keys); },
+                 [&keys](size_t a, size_t b) { return keys.at(a) < keys.at(b); });
+}
+
+// Parallel stable sort with a comparator
+void SortEngine::comparisonSort(std::vector<size_t>& order, const std::function<bool(size_t, size_t)>& less,
+                                ThreadPool& pool) {
+    sortAndMerge(order, pool,
+                 [&less](std::vector<size_t>& range) { std::stable_sort(range.begin(), range.end(), less); },
+                 less);
+}
@@ -0,0 +1,44 @@
+#ifndef SORT_ENGINE_H
+#define SORT_ENGINE_H
+
+#include "PackedStrings.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Stable sorts of a permutation by precomputed keys, without a comparator.
+// order holds element indexes; keys are indexed by element, not by position
+// in order. Both sorts are stable, so sorting by the least significant key
+// first and the most significant last gives a multi-key ordering.
+namespace SortEngine {
+    // 0..count-1
+    std::vector<size_t> identity(size_t count);
+    
+    // Map a signed value onto an unsigned key with the same ordering
+    inline uint32_t orderedKey(int32_t value) { return static_cast<uint32_t>(value) ^ 0x80000000u; }
+    
+    // Append the ASCII lowercase form of value to keys; scratch is reused
+    // across calls to avoid an allocation per key
+    void appendFolded(PackedStrings& keys, std::string_view value, std::string& scratch);
+    
+    // LSD radix sort, one byte per pass; passes in which every key has the
+    // same byte are skipped, so small ranges such as years take two passes
+    void radixSort(std::vector<size_t>& order, const std::vector<uint32_t>& keys);
+    
+    // Multikey (three-way radix) quicksort on bytes; equal keys keep their order
+    void stringSort(std::vector<size_t>& order, const PackedStrings& keys);
+    
+    // Parallel forms: order is split into one contiguous range per thread,
+    // the ranges are sorted concurrently and then merged pairwise, taking
+    // from the earlier range on ties. The result is identical to the
+    // single-threaded sort.
+    void radixSort(std::vector<size_t>& order, const std::vector<uint32_t>& keys, ThreadPool& pool);
+    void stringSort(std::vector<size_t>& order, const PackedStrings& keys, ThreadPool& pool);
+    void comparisonSort(std::vector<size_t>& order, const std::function<bool(size_t, size_t)>& less,
+                        ThreadPool& pool);
+}
+
+#endif // SORT_ENGINE_H
@@ -0,0 +1,30 @@
+#include "Status.h"
+
+// Sentence describing status, for front ends to show
+const char* statusMessage(Status status) {
+    switch (status) {
+        case Status::Ok:
+            return "Success.";
+        case Status::NotFound:
+            return "Book not found.";
+        case Status::EmptyField:
+            return "Title and author cannot be empty.";
+        case Status::InvalidYear:
+            return "Invalid year. Must be between 1000 and 2030.";
+        case Status::InvalidIsbn:
+            return "Invalid ISBN (bad format or check digit).";
+        case Status::DuplicateIsbn:
+            return "A book with this ISBN already exists.";
+        case Status::AlreadyBorrowed:
+            return "Book is already borrowed.";
+        case Status::AlreadyAvailable:
+            return "Book is already available.";
+        case Status::InvalidFile:
+            return "The file is not in the expected format.";
+        case Status::IoError:
+            return "The file could not be read or written.";
+        case Status::DatabaseError:
+            return "The database request failed.";
+    }
+    return "Unknown error.";
+}
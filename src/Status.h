@@ -0,0 +1,22 @@
+#ifndef STATUS_H
+#define STATUS_H
+
+// Outcome of a LibraryManager operation
+enum class Status {
+    Ok,
+    NotFound,          // no book with the given ID
+    EmptyField,        // title or author left empty
+    InvalidYear,       // outside 1000-2030
+    InvalidIsbn,       // bad format or check digit
+    DuplicateIsbn,     // another book already has this ISBN
+    AlreadyBorrowed,
+    AlreadyAvailable,
+    InvalidFile,       // an input file is not in the expected format
+    IoError,           // a file could not be read or written
+    DatabaseError      // the database backend rejected or could not run a request
+};
+
+// Sentence describing status, for front ends to show
+const char* statusMessage(Status status);
+
+#endif // STATUS_H
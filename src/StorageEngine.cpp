@@ -0,0 +1,71 @@
+#include "StorageEngine.h"
+#include "JournaledStorage.h"
+#include "MappedFileStorage.h"
+#include "MemoryStorage.h"
+#include "PostgresStorage.h"
+#include "StreamFileStorage.h"
+
+// Pass a load or save message to the handler, if there is one
+void StorageEngine::report(bool isError, const std::string& message) const {
+    if (messageHandler) {
+        messageHandler(isError, message);
+    }
+}
+
+// Create the engine called engine, storing at location
+std::unique_ptr<StorageEngine> StorageEngine::create(const std::string& engine, const std::string& location) {
+    if (engine == "memory") {
+        return std::make_unique<MemoryStorage>();
+    }
+    if (engine == "file") {
+        return std::make_unique<StreamFileStorage>(location);
+    }
+    if (engine == "mmap") {
+        return std::make_unique<MappedFileStorage>(location);
+    }
+    if (engine == "journaled") {
+        return std::make_unique<JournaledStorage>(location);
+    }
+    if (engine == "postgres") {
+        return std::make_unique<PostgresStorage>(DatabaseManager::fromConnectionString(location));
+    }
+    return nullptr;
+}
+
+// Names create() accepts
+const std::vector<std::string>& StorageEngine::engineNames() {
+    static const std::vector<std::string> names = {"memory", "file", "mmap", "journaled", "postgres"};
+    return names;
+}
+
+// No changes are left over by default
+size_t StorageEngine::recover(const std::function<void(Journal::Operation, const Book&)>&) {
+    return 0;
+}
+
+// Hand out the next free ID
+bool StorageEngine::assignId(Book& book, int& nextId) {
+    book.setId(nextId++);
+    return true;
+}
+
+// Changes wait for the next checkpoint by default
+bool StorageEngine::record(Journal::Operation, const Book&) {
+    return true;
+}
+
+bool StorageEngine::record(Journal::Operation, int) {
+    return true;
+}
+
+bool StorageEngine::checkpoint(const std::vector<Book>&, int) {
+    return true;
+}
+
+// Imported books reach the store with the checkpoint that follows
+bool StorageEngine::finishImport(const std::vector<const Book*>&) {
+    return true;
+}
+
+// Nothing to sync without a journal
+void StorageEngine::setDurability(Journal::Durability) {}
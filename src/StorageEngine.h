@@ -0,0 +1,106 @@
+#ifndef STORAGE_ENGINE_H
+#define STORAGE_ENGINE_H
+
+#include "Book.h"
+#include "DatabaseManager.h"
+#include "Journal.h"
+#include "Status.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class CatalogFile;
+
+// Where a LibraryManager keeps its catalog. The manager holds every book in
+// memory and tells the engine about each change; the engine decides what
+// reaches disk (or a database) when: per operation, at checkpoints, or
+// never. Engines are chosen at startup with create():
+//
+//   memory     nothing is stored; the catalog lives as long as the process
+//   file       the whole catalog is read with streams on first use and
+//              written back at checkpoints
+//   mmap       the data file is mapped and records decoded on first touch;
+//              changes are written back at checkpoints
+//   journaled  mmap, plus every change appended to a journal first, so a
+//              crash loses nothing (the default)
+//   postgres   every change is written through to a PostgreSQL database
+//
+// The manager calls an engine under its write lock, except record() for
+// borrows and returns, which may come from several threads at once.
+class StorageEngine {
+public:
+    using MessageHandler = std::function<void(bool isError, const std::string& message)>;
+
+private:
+    MessageHandler messageHandler;
+
+protected:
+    // Pass a load or save message to the handler, if there is one
+    void report(bool isError, const std::string& message) const;
+
+public:
+    virtual ~StorageEngine() = default;
+
+    // Engine for a name listed above, storing at location (a file name, or a
+    // libpq connection string for postgres); null for an unknown name
+    static std::unique_ptr<StorageEngine> create(const std::string& engine, const std::string& location);
+    static const std::vector<std::string>& engineNames();
+
+    // Receives progress and problems the engine finds
+    void setMessageHandler(MessageHandler handler) { messageHandler = std::move(handler); }
+
+    // Name as accepted by create(), and where the catalog is kept
+    virtual std::string name() const = 0;
+    virtual std::string location() const = 0;
+    // Whether the catalog outlives the process
+    virtual bool isPersistent() const { return true; }
+
+    // Prepare the store; called once, before anything else. False if it
+    // cannot be used (the reason has been reported).
+    virtual bool open() { return true; }
+
+    // Every stored book, and the ID the next new book should get. False if
+    // they could not be read; the manager then refuses to run.
+    virtual bool load(std::vector<Book>& books, int& nextId) = 0;
+    // The mapped data file, for an engine that leaves records undecoded
+    // until they are touched; the manager then builds its rows from this
+    // instead of calling load(). Null otherwise.
+    virtual const CatalogFile* mappedFile() const { return nullptr; }
+
+    // Changes left behind by a session that ended without a checkpoint:
+    // the manager loads the catalog and applies them through apply
+    virtual bool needsRecovery() const { return false; }
+    virtual size_t recover(const std::function<void(Journal::Operation, const Book&)>& apply);
+
+    // Give a new book its ID; by default the next free one. An engine that
+    // stores the book here (rather than through record) may fail.
+    virtual bool assignId(Book& book, int& nextId);
+    // Store one change: Add and Update carry the whole book, the others
+    // only its ID. False if it could not be stored (already reported).
+    virtual bool record(Journal::Operation op, const Book& book);
+    virtual bool record(Journal::Operation op, int id);
+    // What the manager returns for a change this engine failed to store
+    virtual Status failureStatus() const { return Status::IoError; }
+    // Bytes recorded since the last checkpoint; the manager checkpoints once
+    // this passes its threshold
+    virtual uint64_t pendingBytes() const { return 0; }
+    // Store the whole catalog, every book decoded
+    virtual bool checkpoint(const std::vector<Book>& books, int nextId);
+
+    // A CSV import runs between these. Imported books get IDs from
+    // assignId but are not recorded one by one: finishImport receives all
+    // of them (possibly none), and a checkpoint follows. If finishImport
+    // fails the manager takes the books back out.
+    virtual void beginImport() {}
+    virtual bool finishImport(const std::vector<const Book*>& imported);
+
+    // How record() waits for the disk, for engines with a journal
+    virtual void setDurability(Journal::Durability mode);
+    // Read-through cache activity, for engines with a cache
+    virtual DatabaseManager::CacheStats cacheStats() const { return DatabaseManager::CacheStats(); }
+    // Detail of the last failure, if the engine keeps one
+    virtual std::string lastError() const { return std::string(); }
+};
+
+#endif // STORAGE_ENGINE_H
@@ -0,0 +1,73 @@
+#include "StreamFileStorage.h"
+#include "CatalogFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+// Constructor
+StreamFileStorage::StreamFileStorage(const std::string& filename) : filename(filename) {}
+
+// Check the data file can be read before anything is written over it
+bool StreamFileStorage::open() {
+    CatalogFile mapped;
+    if (CatalogFile::isMissingOrEmpty(filename) || mapped.open(filename) || CatalogFile::isLegacy(filename)) {
+        return true;
+    }
+    report(true, "Cannot read data file " + filename +
+                     ": it is damaged, unreadable or from a newer version; it has been left as it was.");
+    return false;
+}
+
+// Read every record in the file; false if any is damaged
+bool StreamFileStorage::load(std::vector<Book>& books, int& nextId) {
+    books.clear();
+    nextId = 1;
+
+    CatalogFile mapped;
+    if (mapped.open(filename)) {
+        books.resize(mapped.recordCount());
+        for (size_t record = 0; record < books.size(); ++record) {
+            if (!mapped.readBook(record, books[record])) {
+                report(true, "Corrupt record " + std::to_string(record) + " in " + filename);
+                return false;
+            }
+        }
+        nextId = mapped.nextId();
+    } else {
+        std::ifstream in(filename, std::ios::binary);
+        if (!in.is_open()) {
+            report(false, "No existing data file found. Starting with empty library.");
+            return true;
+        }
+        while (in.peek() != EOF) {
+            Book book;
+            book.readFromFile(in);
+            if (!in.good()) {
+                report(true, "Truncated record after " + std::to_string(books.size()) + " books in " + filename);
+                return false;
+            }
+            nextId = std::max(nextId, book.getId() + 1);
+            books.push_back(std::move(book));
+        }
+    }
+    report(false, "Loaded " + std::to_string(books.size()) + " books from file.");
+    return true;
+}
+
+// Write every book to a temporary file and rename it over the data file
+bool StreamFileStorage::checkpoint(const std::vector<Book>& books, int) {
+    std::string tempFile = filename + ".tmp";
+    std::ofstream out(tempFile, std::ios::binary | std::ios::trunc);
+    if (out.is_open()) {
+        for (const auto& book : books) {
+            book.writeToFile(out);
+        }
+        out.close();
+    }
+    if (!out || std::rename(tempFile.c_str(), filename.c_str()) != 0) {
+        std::remove(tempFile.c_str());
+        report(true, "Cannot save data to file " + filename);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,31 @@
+#ifndef STREAM_FILE_STORAGE_H
+#define STREAM_FILE_STORAGE_H
+
+#include "StorageEngine.h"
+
+// The catalog as one stream of Book::writeToFile records, the original data
+// file format: read whole on first use and rewritten at each checkpoint
+// (and on exit). Changes in between are lost if the process dies. The
+// format keeps no next ID, so after the newest book is deleted its ID is
+// handed out again.
+//
+// Files written by the mapped engines are read too, so a catalog can be
+// moved to this engine; they are rewritten in the stream format.
+class StreamFileStorage : public StorageEngine {
+private:
+    std::string filename;
+
+public:
+    explicit StreamFileStorage(const std::string& filename);
+
+    std::string name() const override { return "file"; }
+    std::string location() const override { return filename; }
+
+    // Fails if the file exists but is neither a readable mapped-format file
+    // nor a legacy stream
+    bool open() override;
+    bool load(std::vector<Book>& books, int& nextId) override;
+    bool checkpoint(const std::vector<Book>& books, int nextId) override;
+};
+
+#endif // STREAM_FILE_STORAGE_H
@@ -0,0 +1,26 @@
+#include "StringPool.h"
+
+// ID of value, adding it if it is new
+uint32_t StringPool::intern(std::string_view value) {
+    auto it = ids.find(value);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    
+    uint32_t id = static_cast<uint32_t>(values.size());
+    values.push_back(std::make_shared<const std::string>(value));
+    ids.emplace(*values.back(), id);
+    return id;
+}
+
+// ID of value, or NOT_FOUND
+uint32_t StringPool::find(std::string_view value) const {
+    auto it = ids.find(value);
+    return it != ids.end() ? it->second : NOT_FOUND;
+}
+
+// Remove all values
+void StringPool::clear() {
+    ids.clear();
+    values.clear();
+}
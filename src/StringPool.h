@@ -0,0 +1,31 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Dictionary of distinct strings with small integer IDs, assigned in
+// insertion order. Values are immutable and shared, so records that hold
+// the same author or category point at one copy.
+class StringPool {
+private:
+    std::vector<std::shared_ptr<const std::string>> values;
+    std::unordered_map<std::string_view, uint32_t> ids;  // views into values
+    
+public:
+    static const uint32_t NOT_FOUND = UINT32_MAX;
+    
+    uint32_t intern(std::string_view value);
+    uint32_t find(std::string_view value) const;
+    
+    const std::string& at(uint32_t id) const { return *values[id]; }
+    const std::shared_ptr<const std::string>& shared(uint32_t id) const { return values[id]; }
+    size_t size() const { return values.size(); }
+    void clear();
+};
+
+#endif // STRING_POOL_H
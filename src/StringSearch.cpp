@@ -0,0 +1,202 @@
+#include "StringSearch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define STRING_SEARCH_X86 1
+#include <immintrin.h>
+#endif
+
+// All kernels use the same filter: compare the first and last needle bytes
+// against a whole block of haystack positions at once, then verify only the
+// positions where both match. Letters are folded by OR-ing in 0x20, which is
+// exact for a lowercase letter target (only 'x' and 'X' map to 'x').
+
+namespace {
+
+using SearchFunction = bool (*)(const char*, size_t, const char*, size_t);
+
+inline unsigned char foldMask(char c) {
+    return (c >= 'a' && c <= 'z') ? 0x20 : 0x00;
+}
+
+inline char toLowerAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+}
+
+// Compare count haystack bytes against lowercase needle bytes
+inline bool equalsIgnoreCase(const char* haystack, const char* lowerNeedle, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (toLowerAscii(haystack[i]) != lowerNeedle[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Check candidate positions start..end-1 one at a time
+inline bool scanRange(const char* haystack, size_t start, size_t end,
+                      const char* needle, size_t needleLen) {
+    for (size_t i = start; i < end; ++i) {
+        if (equalsIgnoreCase(haystack + i, needle, needleLen)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool searchScalar(const char* haystack, size_t haystackLen, const char* needle, size_t needleLen) {
+    return scanRange(haystack, 0, haystackLen - needleLen + 1, needle, needleLen);
+}
+
+#ifdef STRING_SEARCH_X86
+
+bool searchSSE2(const char* haystack, size_t haystackLen, const char* needle, size_t needleLen) {
+    const size_t last = needleLen - 1;
+    const size_t positions = haystackLen - needleLen + 1;
+    const __m128i firstMask = _mm_set1_epi8(static_cast<char>(foldMask(needle[0])));
+    const __m128i firstByte = _mm_set1_epi8(needle[0]);
+    const __m128i lastMask = _mm_set1_epi8(static_cast<char>(foldMask(needle[last])));
+    const __m128i lastByte = _mm_set1_epi8(needle[last]);
+    
+    size_t i = 0;
+    for (; i + 16 <= positions; i += 16) {
+        __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i));
+        __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i + last));
+        __m128i headEq = _mm_cmpeq_epi8(_mm_or_si128(head, firstMask), firstByte);
+        __m128i tailEq = _mm_cmpeq_epi8(_mm_or_si128(tail, lastMask), lastByte);
+        unsigned bits = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(headEq, tailEq)));
+        while (bits != 0) {
+            unsigned offset = static_cast<unsigned>(__builtin_ctz(bits));
+            if (equalsIgnoreCase(haystack + i + offset + 1, needle + 1, needleLen - 1)) {
+                return true;
+            }
+            bits &= bits - 1;
+        }
+    }
+    return scanRange(haystack, i, positions, needle, needleLen);
+}
+
+__attribute__((target("avx2")))
+bool searchAVX2(const char* haystack, size_t haystackLen, const char* needle, size_t needleLen) {
+    const size_t last = needleLen - 1;
+    const size_t positions = haystackLen - needleLen + 1;
+    // Most titles are shorter than one AVX2 block; don't touch ymm state for them
+    if (positions < 32) {
+        return searchSSE2(haystack, haystackLen, needle, needleLen);
+    }
+    
+    const __m256i firstMask = _mm256_set1_epi8(static_cast<char>(foldMask(needle[0])));
+    const __m256i firstByte = _mm256_set1_epi8(needle[0]);
+    const __m256i lastMask = _mm256_set1_epi8(static_cast<char>(foldMask(needle[last])));
+    const __m256i lastByte = _mm256_set1_epi8(needle[last]);
+    
+    size_t i = 0;
+    for (; i + 32 <= positions; i += 32) {
+        __m256i head = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i));
+        __m256i tail = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i + last));
+        __m256i headEq = _mm256_cmpeq_epi8(_mm256_or_si256(head, firstMask), firstByte);
+        __m256i tailEq = _mm256_cmpeq_epi8(_mm256_or_si256(tail, lastMask), lastByte);
+        unsigned bits = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(headEq, tailEq)));
+        while (bits != 0) {
+            unsigned offset = static_cast<unsigned>(__builtin_ctz(bits));
+            if (equalsIgnoreCase(haystack + i + offset + 1, needle + 1, needleLen - 1)) {
+                return true;
+            }
+            bits &= bits - 1;
+        }
+    }
+    // Clear the upper ymm halves before running legacy-SSE code on the tail
+    _mm256_zeroupper();
+    return searchSSE2(haystack + i, haystackLen - i, needle, needleLen);
+}
+
+#endif // STRING_SEARCH_X86
+
+SearchFunction functionFor(StringSearch::Kernel kernel) {
+#ifdef STRING_SEARCH_X86
+    switch (kernel) {
+        case StringSearch::Kernel::AVX2:
+            return searchAVX2;
+        case StringSearch::Kernel::SSE2:
+            return searchSSE2;
+        case StringSearch::Kernel::Scalar:
+            break;
+    }
+#else
+    (void)kernel;
+#endif
+    return searchScalar;
+}
+
+StringSearch::Kernel detectKernel() {
+    if (StringSearch::isSupported(StringSearch::Kernel::AVX2)) {
+        return StringSearch::Kernel::AVX2;
+    }
+    if (StringSearch::isSupported(StringSearch::Kernel::SSE2)) {
+        return StringSearch::Kernel::SSE2;
+    }
+    return StringSearch::Kernel::Scalar;
+}
+
+}  // namespace
+
+// Kernel chosen for this CPU (resolved once)
+StringSearch::Kernel StringSearch::activeKernel() {
+    static const Kernel kernel = detectKernel();
+    return kernel;
+}
+
+// Human-readable kernel name
+const char* StringSearch::kernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::AVX2:
+            return "avx2";
+        case Kernel::SSE2:
+            return "sse2";
+        case Kernel::Scalar:
+            break;
+    }
+    return "scalar";
+}
+
+// Check whether the CPU can run a kernel
+bool StringSearch::isSupported(Kernel kernel) {
+#ifdef STRING_SEARCH_X86
+    switch (kernel) {
+        case Kernel::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case Kernel::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case Kernel::Scalar:
+            return true;
+    }
+    return false;
+#else
+    return kernel == Kernel::Scalar;
+#endif
+}
+
+// Search with the active kernel
+bool StringSearch::containsIgnoreCase(std::string_view haystack, std::string_view lowerNeedle) {
+    static const SearchFunction search = functionFor(activeKernel());
+    if (lowerNeedle.empty()) {
+        return true;
+    }
+    if (lowerNeedle.size() > haystack.size()) {
+        return false;
+    }
+    return search(haystack.data(), haystack.size(), lowerNeedle.data(), lowerNeedle.size());
+}
+
+// Search with an explicit kernel (used by benchmarks)
+bool StringSearch::containsIgnoreCase(Kernel kernel, std::string_view haystack, std::string_view lowerNeedle) {
+    if (lowerNeedle.empty()) {
+        return true;
+    }
+    if (lowerNeedle.size() > haystack.size()) {
+        return false;
+    }
+    if (!isSupported(kernel)) {
+        kernel = Kernel::Scalar;
+    }
+    return functionFor(kernel)(haystack.data(), haystack.size(), lowerNeedle.data(), lowerNeedle.size());
+}
@@ -0,0 +1,21 @@
+#ifndef STRING_SEARCH_H
+#define STRING_SEARCH_H
+
+#include <string_view>
+
+// ASCII case-insensitive substring search over bytes in place.
+// The kernel is picked once at runtime from what the CPU supports.
+namespace StringSearch {
+    enum class Kernel { Scalar, SSE2, AVX2 };
+    
+    Kernel activeKernel();
+    const char* kernelName(Kernel kernel);
+    bool isSupported(Kernel kernel);
+    
+    // True if haystack contains lowerNeedle, ignoring ASCII case in haystack.
+    // lowerNeedle must already be lowercase.
+    bool containsIgnoreCase(std::string_view haystack, std::string_view lowerNeedle);
+    bool containsIgnoreCase(Kernel kernel, std::string_view haystack, std::string_view lowerNeedle);
+}
+
+#endif // STRING_SEARCH_H
@@ -0,0 +1,118 @@
+#include "TableRenderer.h"
+#include "Book.h"
+#include <charconv>
+
+namespace {
+
+// Column widths, each including at least one space of padding
+const size_t ID_WIDTH = 9;
+const size_t TITLE_WIDTH = 25;
+const size_t AUTHOR_WIDTH = 20;
+const size_t YEAR_WIDTH = 6;
+const size_t ISBN_WIDTH = 18;
+const size_t CATEGORY_WIDTH = 15;
+const size_t STATUS_WIDTH = 10;
+
+// Marks a cell cut short; one column wide
+const char* const ELLIPSIS = "\xe2\x80\xa6";
+
+bool isContinuationByte(char c) {
+    return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+}  // namespace
+
+// Constructor
+TableRenderer::TableRenderer(std::ostream& out) : out(out) {
+    buffer.reserve(WRITE_BYTES + 4096);
+}
+
+// Destructor
+TableRenderer::~TableRenderer() {
+    flush();
+}
+
+// Append text padded or cut to width columns, leaving at least one space
+void TableRenderer::addCell(std::string_view text, size_t width) {
+    size_t room = width - 1;
+    
+    // Count code points up to room; a lead byte starts one, continuation bytes do not
+    size_t columns = 0;
+    size_t end = 0;
+    size_t cut = 0;  // end of the first room - 1 code points
+    while (end < text.size() && columns < room) {
+        ++end;
+        while (end < text.size() && isContinuationByte(text[end])) {
+            ++end;
+        }
+        ++columns;
+        if (columns == room - 1) {
+            cut = end;
+        }
+    }
+    
+    bool truncated = end < text.size();
+    std::string_view shown = text.substr(0, truncated ? cut : end);
+    for (char c : shown) {
+        buffer += (c == '\n' || c == '\r' || c == '\t') ? ' ' : c;
+    }
+    if (truncated) {
+        buffer += ELLIPSIS;
+    }
+    buffer.append(width - columns, ' ');
+}
+
+// Write the buffer out once it has grown past WRITE_BYTES
+void TableRenderer::writeIfFull() {
+    if (buffer.size() >= WRITE_BYTES) {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+}
+
+// Column headings
+void TableRenderer::addHeader() {
+    addCell("ID", ID_WIDTH);
+    addCell("Title", TITLE_WIDTH);
+    addCell("Author", AUTHOR_WIDTH);
+    addCell("Year", YEAR_WIDTH);
+    addCell("ISBN", ISBN_WIDTH);
+    addCell("Category", CATEGORY_WIDTH);
+    addCell("Status", STATUS_WIDTH);
+    buffer += '\n';
+}
+
+// One book
+void TableRenderer::addRow(const Book& book) {
+    char digits[16];
+    auto id = std::to_chars(digits, digits + sizeof(digits), book.getId());
+    addCell(std::string_view(digits, id.ptr - digits), ID_WIDTH);
+    addCell(book.getTitle(), TITLE_WIDTH);
+    addCell(book.getAuthor(), AUTHOR_WIDTH);
+    auto year = std::to_chars(digits, digits + sizeof(digits), book.getYear());
+    addCell(std::string_view(digits, year.ptr - digits), YEAR_WIDTH);
+    addCell(book.getIsbn(), ISBN_WIDTH);
+    addCell(book.getCategory(), CATEGORY_WIDTH);
+    addCell(book.getAvailability() ? "Available" : "Borrowed", STATUS_WIDTH);
+    buffer += '\n';
+    writeIfFull();
+}
+
+// A full-width line of fill
+void TableRenderer::addRule(char fill) {
+    buffer.append(WIDTH, fill);
+    buffer += '\n';
+}
+
+// A line of free text
+void TableRenderer::addLine(std::string_view text) {
+    buffer.append(text.data(), text.size());
+    buffer += '\n';
+}
+
+// Write the buffer and flush the stream
+void TableRenderer::flush() {
+    out.write(buffer.data(), buffer.size());
+    buffer.clear();
+    out.flush();
+}
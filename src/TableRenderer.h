@@ -0,0 +1,49 @@
+#ifndef TABLE_RENDERER_H
+#define TABLE_RENDERER_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+class Book;
+
+// Fixed-width book table built in one buffer and written to the stream in
+// large blocks, never a line at a time. Cells are cut to their column
+// width by UTF-8 code point rather than by byte, so multi-byte text keeps
+// the columns aligned and is never split inside a character; line breaks
+// and tabs in a cell are shown as spaces.
+class TableRenderer {
+private:
+    std::ostream& out;
+    std::string buffer;
+    
+    void addCell(std::string_view text, size_t width);
+    void writeIfFull();
+    
+public:
+    // Width of the rules drawn above and below the table
+    static const size_t WIDTH = 105;
+    
+    // Buffered bytes at which the buffer is written out
+    static const size_t WRITE_BYTES = 1 << 20;
+    
+    // Constructors
+    explicit TableRenderer(std::ostream& out);
+    TableRenderer(const TableRenderer&) = delete;
+    TableRenderer& operator=(const TableRenderer&) = delete;
+    
+    // Destructor; writes and flushes whatever is still buffered
+    ~TableRenderer();
+    
+    // Table parts
+    void addHeader();
+    void addRow(const Book& book);
+    void addRule(char fill);
+    void addLine(std::string_view text);
+    
+    // Write the buffer and flush the stream
+    void flush();
+};
+
+#endif // TABLE_RENDERER_H
@@ -0,0 +1,79 @@
+#include "ThreadPool.h"
+
+// Start threads - 1 workers
+ThreadPool::ThreadPool(unsigned threads)
+    : task(nullptr), taskCount(0), nextIndex(0), finished(0), generation(0), stopping(false) {
+    for (unsigned i = 1; i < threads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+// Stop and join the workers
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// Claim and run one index of the current loop. Called with lock held;
+// the lock is released while the task runs. False if none are left.
+bool ThreadPool::runOne(std::unique_lock<std::mutex>& lock) {
+    if (!task || nextIndex >= taskCount) {
+        return false;
+    }
+    size_t index = nextIndex++;
+    const std::function<void(size_t)>& current = *task;
+
+    lock.unlock();
+    current(index);
+    lock.lock();
+
+    if (++finished == taskCount) {
+        done.notify_all();
+    }
+    return true;
+}
+
+// Wait for loops and help run them
+void ThreadPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    unsigned seen = generation;
+    while (true) {
+        wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+        if (stopping) {
+            return;
+        }
+        seen = generation;
+        while (runOne(lock)) {
+        }
+    }
+}
+
+// Run a loop on the pool and the calling thread
+void ThreadPool::run(size_t count, const std::function<void(size_t)>& loopTask) {
+    std::unique_lock<std::mutex> running(runMutex, std::defer_lock);
+    if (workers.empty() || count <= 1 || !running.try_lock()) {
+        for (size_t i = 0; i < count; ++i) {
+            loopTask(i);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    task = &loopTask;
+    taskCount = count;
+    nextIndex = 0;
+    finished = 0;
+    ++generation;
+    wake.notify_all();
+
+    while (runOne(lock)) {
+    }
+    done.wait(lock, [this] { return finished == taskCount; });
+    task = nullptr;
+}
@@ -0,0 +1,51 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops. The calling thread
+// works too, so a pool of size n starts n - 1 threads.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex runMutex;  // held by the caller whose loop the pool is running
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    // The loop currently running; guarded by mutex
+    const std::function<void(size_t)>* task;
+    size_t taskCount;
+    size_t nextIndex;
+    size_t finished;
+    unsigned generation;
+    bool stopping;
+
+    void workerLoop();
+    bool runOne(std::unique_lock<std::mutex>& lock);
+
+public:
+    // Constructors
+    explicit ThreadPool(unsigned threads);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Destructor
+    ~ThreadPool();
+
+    // Number of threads that run tasks, including the caller
+    unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // Call task(i) for every i in [0, count), spread over the pool, and
+    // return once all calls have finished. The pool runs one loop at a time;
+    // another thread that calls run meanwhile runs its loop itself instead
+    // of waiting. Not reentrant.
+    void run(size_t count, const std::function<void(size_t)>& task);
+};
+
+#endif // THREAD_POOL_H
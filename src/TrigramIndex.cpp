@@ -0,0 +1,108 @@
+#include "TrigramIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+// Distinct case-folded trigrams of text, sorted
+std::vector<uint32_t> TrigramIndex::trigramsOf(std::string_view text) {
+    std::vector<uint32_t> trigrams;
+    if (text.size() < MIN_QUERY_LENGTH) {
+        return trigrams;
+    }
+    
+    trigrams.reserve(text.size() - 2);
+    for (size_t i = 0; i + 2 < text.size(); ++i) {
+        uint32_t a = static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(text[i])));
+        uint32_t b = static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(text[i + 1])));
+        uint32_t c = static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(text[i + 2])));
+        trigrams.push_back((a << 16) | (b << 8) | c);
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+// Index text under the given book ID
+void TrigramIndex::add(int id, std::string_view text) {
+    for (uint32_t trigram : trigramsOf(text)) {
+        Postings& list = postings[trigram];
+        // Re-adding a removed ID just clears its mark
+        if (!list.removed.empty() && list.removed.erase(id) > 0) {
+            continue;
+        }
+        // IDs are normally assigned in increasing order, so this is an append
+        if (list.ids.empty() || list.ids.back() < id) {
+            list.ids.push_back(id);
+        } else {
+            auto pos = std::lower_bound(list.ids.begin(), list.ids.end(), id);
+            if (pos == list.ids.end() || *pos != id) {
+                list.ids.insert(pos, id);
+            }
+        }
+    }
+}
+
+// Remove the entries previously added for text under the given book ID
+void TrigramIndex::remove(int id, std::string_view text) {
+    for (uint32_t trigram : trigramsOf(text)) {
+        auto it = postings.find(trigram);
+        if (it == postings.end()) {
+            continue;
+        }
+        Postings& list = it->second;
+        if (!std::binary_search(list.ids.begin(), list.ids.end(), id) || !list.removed.insert(id).second) {
+            continue;
+        }
+        if (list.removed.size() * 4 >= list.ids.size()) {
+            compact(list);
+        }
+        if (list.ids.empty()) {
+            postings.erase(it);
+        }
+    }
+}
+
+// Drop the IDs marked removed from list
+void TrigramIndex::compact(Postings& list) {
+    list.ids.erase(std::remove_if(list.ids.begin(), list.ids.end(),
+                                  [&list](int id) { return list.removed.count(id) > 0; }),
+                   list.ids.end());
+    list.removed.clear();
+}
+
+// Intersect the posting lists of every trigram in query, leaving out IDs
+// marked removed from any of them
+std::vector<int> TrigramIndex::candidates(const std::string& query) const {
+    std::vector<const Postings*> lists;
+    for (uint32_t trigram : trigramsOf(query)) {
+        auto it = postings.find(trigram);
+        if (it == postings.end()) {
+            return {};
+        }
+        lists.push_back(&it->second);
+    }
+    if (lists.empty()) {
+        return {};
+    }
+    
+    // Start from the shortest list so intermediate results stay small
+    std::sort(lists.begin(), lists.end(),
+              [](const Postings* a, const Postings* b) { return a->ids.size() < b->ids.size(); });
+    
+    std::vector<int> result = lists.front()->ids;
+    std::vector<int> scratch;
+    for (size_t i = 1; i < lists.size() && !result.empty(); ++i) {
+        scratch.clear();
+        std::set_intersection(result.begin(), result.end(),
+                              lists[i]->ids.begin(), lists[i]->ids.end(), std::back_inserter(scratch));
+        result.swap(scratch);
+    }
+    for (const Postings* list : lists) {
+        if (!list->removed.empty()) {
+            result.erase(std::remove_if(result.begin(), result.end(),
+                                        [list](int id) { return list->removed.count(id) > 0; }),
+                         result.end());
+        }
+    }
+    return result;
+}
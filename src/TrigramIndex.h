@@ -0,0 +1,42 @@
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+
+// Inverted index from case-folded 3-byte substrings to the book IDs whose
+// text contains them. Used to narrow substring searches to candidate records.
+// Trigrams common to most books have lists as long as the catalog, so a
+// removed ID is only marked, and dropped from its list once a quarter of the
+// list is marked.
+class TrigramIndex {
+private:
+    struct Postings {
+        std::vector<int> ids;             // ascending, including removed IDs
+        std::unordered_set<int> removed;  // IDs in ids whose text no longer has the trigram
+    };
+    
+    // Packed trigram -> its postings
+    std::unordered_map<uint32_t, Postings> postings;
+    
+    static std::vector<uint32_t> trigramsOf(std::string_view text);
+    static void compact(Postings& list);
+    
+public:
+    static const size_t MIN_QUERY_LENGTH = 3;
+    
+    void add(int id, std::string_view text);
+    void remove(int id, std::string_view text);
+    void clear() { postings.clear(); }
+    
+    // IDs of records containing every trigram of query, ascending.
+    // The query must be at least MIN_QUERY_LENGTH bytes; callers still have to
+    // verify candidates since matching trigrams do not imply a substring match.
+    std::vector<int> candidates(const std::string& query) const;
+};
+
+#endif // TRIGRAM_INDEX_H
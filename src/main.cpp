@@ -1,9 +1,165 @@
 #include "Menu.h"
+#include "BatchRunner.h"
+#include "PostgresStorage.h"
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
 
-int main() {
+namespace {
+
+// Where the catalog is kept, from the command line
+struct StorageChoice {
+    std::string engine;  // empty: journaled, or postgres with a connection string
+    std::string dataFile = "library_data.bin";
+    std::string connectionString;
+};
+
+// Print command line usage
+void printUsage(const char* program) {
+    std::string engines;
+    for (const std::string& name : StorageEngine::engineNames()) {
+        engines += (engines.empty() ? "" : "|") + name;
+    }
+    std::cerr << "Usage: " << program << " [storage]  interactive menu\n"
+              << "       " << program << " --batch [script] [storage] [--threads n]\n"
+              << "           run commands from script (or standard input) without prompts\n"
+              << "Storage: [--storage " << engines << "] [--data file | --database conninfo]\n"
+              << "       --storage picks the storage engine (default journaled, or postgres with --database)\n"
+              << "       --database keeps the catalog in PostgreSQL, e.g. \"host=localhost dbname=library_db\"\n";
+}
+
+// Consume the storage option at argv[i], if it is one
+bool parseStorageOption(int argc, char* argv[], int& i, StorageChoice& choice) {
+    if (i + 1 >= argc) {
+        return false;
+    }
+    if (std::strcmp(argv[i], "--storage") == 0) {
+        choice.engine = argv[++i];
+    } else if (std::strcmp(argv[i], "--data") == 0) {
+        choice.dataFile = argv[++i];
+    } else if (std::strcmp(argv[i], "--database") == 0) {
+        choice.connectionString = argv[++i];
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Connected database manager for a libpq connection string, or null
+std::shared_ptr<DatabaseManager> openDatabase(const std::string& connectionString) {
+    std::shared_ptr<DatabaseManager> database = DatabaseManager::fromConnectionString(connectionString);
+    if (!database->connect()) {
+        std::cerr << "Error: Cannot connect to database: " << database->getLastError() << std::endl;
+        return nullptr;
+    }
+    return database;
+}
+
+// Storage engine for the command line choice, or null after printing why not
+std::unique_ptr<StorageEngine> openStorage(const StorageChoice& choice) {
+    std::string engine = choice.engine;
+    if (engine.empty()) {
+        engine = choice.connectionString.empty() ? "journaled" : "postgres";
+    }
+    if (engine == "postgres") {
+        if (choice.connectionString.empty()) {
+            std::cerr << "Error: The postgres storage engine needs --database conninfo" << std::endl;
+            return nullptr;
+        }
+        std::shared_ptr<DatabaseManager> database = openDatabase(choice.connectionString);
+        return database ? std::make_unique<PostgresStorage>(database) : nullptr;
+    }
+    
+    std::unique_ptr<StorageEngine> storage = StorageEngine::create(engine, choice.dataFile);
+    if (!storage) {
+        std::cerr << "Error: Unknown storage engine " << engine << std::endl;
+    }
+    return storage;
+}
+
+// Run a command script against the data file and report totals
+int runBatch(int argc, char* argv[]) {
+    std::string scriptFile;
+    StorageChoice storage;
+    unsigned threads = 1;
+    for (int i = 2; i < argc; ++i) {
+        if (parseStorageOption(argc, argv, i, storage)) {
+            continue;
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (argv[i][0] != '-' && scriptFile.empty()) {
+            scriptFile = argv[i];
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    
+    std::ifstream file;
+    if (!scriptFile.empty()) {
+        file.open(scriptFile);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot open script " << scriptFile << std::endl;
+            return 1;
+        }
+    }
+    
+    // Only file errors are shown; loading progress would be per-run noise
+    LibraryManager::MessageHandler showErrors = [](bool isError, const std::string& message) {
+        if (isError) {
+            std::cerr << "Error: " << message << std::endl;
+        }
+    };
+    std::unique_ptr<StorageEngine> engine = openStorage(storage);
+    if (!engine) {
+        return 1;
+    }
+    auto manager = std::make_unique<LibraryManager>(std::move(engine), showErrors);
+    if (!manager->isOpen()) {
+        return 1;
+    }
+    manager->setThreadCount(threads);
+    
+    BatchRunner runner(*manager);
+    BatchRunner::Summary summary = runner.run(scriptFile.empty() ? std::cin : file);
+    
+    for (const std::string& error : summary.errors) {
+        std::cerr << "Error: " << error << "\n";
+    }
+    if (summary.failed > summary.errors.size()) {
+        std::cerr << "... and " << summary.failed - summary.errors.size() << " more failed commands\n";
+    }
+    long rate = summary.seconds > 0 ? static_cast<long>(summary.commands / summary.seconds) : 0;
+    std::cout << "Ran " << summary.commands << " commands in " << static_cast<long>(summary.seconds * 1000)
+              << " ms (" << rate << " commands/sec); " << summary.failed << " failed, " << summary.matches
+              << " books found by searches.\n";
+    return summary.failed == 0 ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
     try {
-        Menu menu;
+        if (argc > 1 && std::strcmp(argv[1], "--batch") == 0) {
+            return runBatch(argc, argv);
+        }
+        StorageChoice choice;
+        for (int i = 1; i < argc; ++i) {
+            if (!parseStorageOption(argc, argv, i, choice)) {
+                printUsage(argv[0]);
+                return 2;
+            }
+        }
+        std::unique_ptr<StorageEngine> storage = openStorage(choice);
+        if (!storage) {
+            return 1;
+        }
+        
+        Menu menu(std::move(storage));
+        if (!menu.isReady()) {
+            return 1;
+        }
         menu.run();
     } catch (const std::exception& e) {
         std::cerr << "An error occurred: " << e.what() << std::endl;